@@ -0,0 +1,259 @@
+#include "AABBTree.h"
+#include <algorithm>
+
+namespace {
+	// Fat boxes are stretched this many displacements ahead of a mover,
+	// by at most MAX_STRETCH margins (so teleports don't leave a huge box).
+	const float DISPLACEMENT_MULTIPLIER = 2.0f;
+	const float MAX_STRETCH = 2.0f;
+
+	// A fat box looser than this many margins on any side is shrunk.
+	const float MAX_SLACK = 4.0f;
+
+	float perimeter(float min_x, float min_y, float max_x, float max_y) {
+		return 2.0f * ((max_x - min_x) + (max_y - min_y));
+	}
+}
+
+// Create empty tree. Fat boxes are padded by margin on every side.
+AABBTree::AABBTree(float margin)
+	: m_root(NULL_NODE), m_free(NULL_NODE), m_leaf_count(0), m_margin(margin) {}
+
+// Take a node off the free list, growing storage if it is empty.
+int AABBTree::allocateNode() {
+	if (m_free == NULL_NODE) {
+		m_nodes.push_back(Node());
+		m_nodes.back().parent = NULL_NODE;
+		m_free = static_cast<int>(m_nodes.size()) - 1;
+	}
+	const int id = m_free;
+	Node& n = m_nodes[static_cast<std::size_t>(id)];
+	m_free = n.parent;
+	n.parent = n.child1 = n.child2 = NULL_NODE;
+	n.p_object = nullptr;
+	n.height = 0;
+	return id;
+}
+
+void AABBTree::freeNode(int id) {
+	Node& n = m_nodes[static_cast<std::size_t>(id)];
+	n.parent = m_free;
+	n.height = -1;
+	m_free = id;
+}
+
+// Recompute box and height of node id from its children.
+void AABBTree::refit(int id) {
+	Node& n = m_nodes[static_cast<std::size_t>(id)];
+	const Node& a = m_nodes[static_cast<std::size_t>(n.child1)];
+	const Node& b = m_nodes[static_cast<std::size_t>(n.child2)];
+	n.min_x = std::min(a.min_x, b.min_x);
+	n.min_y = std::min(a.min_y, b.min_y);
+	n.max_x = std::max(a.max_x, b.max_x);
+	n.max_y = std::max(a.max_y, b.max_y);
+	n.height = 1 + std::max(a.height, b.height);
+}
+
+// Add Object with box. Return its proxy id.
+int AABBTree::insert(Object* p_o, const Box& box) {
+	const int id = allocateNode();
+	Node& n = m_nodes[static_cast<std::size_t>(id)];
+	n.min_x = box.getCorner().getX() - m_margin;
+	n.min_y = box.getCorner().getY() - m_margin;
+	n.max_x = box.getCorner().getX() + box.getHorizontal() + m_margin;
+	n.max_y = box.getCorner().getY() + box.getVertical() + m_margin;
+	n.p_object = p_o;
+	insertLeaf(id);
+	++m_leaf_count;
+	return id;
+}
+
+// Remove proxy.
+void AABBTree::remove(int proxy) {
+	if (proxy < 0 || static_cast<std::size_t>(proxy) >= m_nodes.size()) return;
+	if (m_nodes[static_cast<std::size_t>(proxy)].height != 0) return; // not a live leaf
+	removeLeaf(proxy);
+	freeNode(proxy);
+	--m_leaf_count;
+}
+
+// Update proxy to box after moving by displacement. Return true if reinserted.
+bool AABBTree::move(int proxy, const Box& box, const Vector& displacement) {
+	if (proxy < 0 || static_cast<std::size_t>(proxy) >= m_nodes.size()) return false;
+	Node& n = m_nodes[static_cast<std::size_t>(proxy)];
+	if (n.height != 0) return false;
+
+	float min_x = box.getCorner().getX(), min_y = box.getCorner().getY();
+	float max_x = min_x + box.getHorizontal(), max_y = min_y + box.getVertical();
+	if (n.min_x <= min_x && n.min_y <= min_y && max_x <= n.max_x && max_y <= n.max_y) {
+		// Still inside fat box; keep it unless it has become far too loose.
+		const float slack = MAX_SLACK * m_margin;
+		if (min_x - n.min_x <= slack && min_y - n.min_y <= slack
+			&& n.max_x - max_x <= slack && n.max_y - max_y <= slack)
+			return false;
+	}
+
+	removeLeaf(proxy);
+	min_x -= m_margin; min_y -= m_margin;
+	max_x += m_margin; max_y += m_margin;
+	const float stretch = MAX_STRETCH * m_margin;
+	const float dx = std::max(-stretch, std::min(stretch, DISPLACEMENT_MULTIPLIER * displacement.getX()));
+	const float dy = std::max(-stretch, std::min(stretch, DISPLACEMENT_MULTIPLIER * displacement.getY()));
+	if (dx < 0.0f) min_x += dx; else max_x += dx;
+	if (dy < 0.0f) min_y += dy; else max_y += dy;
+
+	Node& leaf = m_nodes[static_cast<std::size_t>(proxy)];
+	leaf.min_x = min_x; leaf.min_y = min_y;
+	leaf.max_x = max_x; leaf.max_y = max_y;
+	insertLeaf(proxy);
+	return true;
+}
+
+// Link leaf in next to the sibling that grows the tree's perimeter least.
+void AABBTree::insertLeaf(int leaf) {
+	if (m_root == NULL_NODE) {
+		m_root = leaf;
+		m_nodes[static_cast<std::size_t>(leaf)].parent = NULL_NODE;
+		return;
+	}
+
+	const Node l = m_nodes[static_cast<std::size_t>(leaf)];
+	int index = m_root;
+	while (!m_nodes[static_cast<std::size_t>(index)].isLeaf()) {
+		const Node& n = m_nodes[static_cast<std::size_t>(index)];
+		const float area = perimeter(n.min_x, n.min_y, n.max_x, n.max_y);
+		const float combined = perimeter(std::min(n.min_x, l.min_x), std::min(n.min_y, l.min_y),
+			std::max(n.max_x, l.max_x), std::max(n.max_y, l.max_y));
+
+		// Cost of making a new parent for this node and the leaf, and the
+		// cost every level below pays for this node growing.
+		const float cost = 2.0f * combined;
+		const float inheritance = 2.0f * (combined - area);
+
+		float child_cost[2];
+		const int children[2] = { n.child1, n.child2 };
+		for (int i = 0; i < 2; ++i) {
+			const Node& c = m_nodes[static_cast<std::size_t>(children[i])];
+			const float grown = perimeter(std::min(c.min_x, l.min_x), std::min(c.min_y, l.min_y),
+				std::max(c.max_x, l.max_x), std::max(c.max_y, l.max_y));
+			child_cost[i] = (c.isLeaf() ? grown : grown - perimeter(c.min_x, c.min_y, c.max_x, c.max_y)) + inheritance;
+		}
+
+		if (cost < child_cost[0] && cost < child_cost[1]) break;
+		index = child_cost[0] < child_cost[1] ? children[0] : children[1];
+	}
+
+	// Replace the sibling with a new parent of sibling and leaf.
+	const int sibling = index;
+	const int new_parent = allocateNode();
+	const int old_parent = m_nodes[static_cast<std::size_t>(sibling)].parent;
+	Node& p = m_nodes[static_cast<std::size_t>(new_parent)];
+	p.parent = old_parent;
+	p.child1 = sibling;
+	p.child2 = leaf;
+	m_nodes[static_cast<std::size_t>(sibling)].parent = new_parent;
+	m_nodes[static_cast<std::size_t>(leaf)].parent = new_parent;
+	refit(new_parent);
+
+	if (old_parent == NULL_NODE) m_root = new_parent;
+	else {
+		Node& op = m_nodes[static_cast<std::size_t>(old_parent)];
+		if (op.child1 == sibling) op.child1 = new_parent;
+		else op.child2 = new_parent;
+	}
+
+	// Walk back up fixing boxes and heights.
+	for (int i = m_nodes[static_cast<std::size_t>(leaf)].parent; i != NULL_NODE;
+		i = m_nodes[static_cast<std::size_t>(i)].parent) {
+		i = balance(i);
+		refit(i);
+	}
+}
+
+// Unlink leaf; its sibling takes the place of their parent.
+void AABBTree::removeLeaf(int leaf) {
+	if (leaf == m_root) {
+		m_root = NULL_NODE;
+		return;
+	}
+
+	const int parent = m_nodes[static_cast<std::size_t>(leaf)].parent;
+	const Node& p = m_nodes[static_cast<std::size_t>(parent)];
+	const int grandparent = p.parent;
+	const int sibling = p.child1 == leaf ? p.child2 : p.child1;
+
+	if (grandparent == NULL_NODE) {
+		m_root = sibling;
+		m_nodes[static_cast<std::size_t>(sibling)].parent = NULL_NODE;
+		freeNode(parent);
+		return;
+	}
+
+	Node& g = m_nodes[static_cast<std::size_t>(grandparent)];
+	if (g.child1 == parent) g.child1 = sibling;
+	else g.child2 = sibling;
+	m_nodes[static_cast<std::size_t>(sibling)].parent = grandparent;
+	freeNode(parent);
+
+	for (int i = grandparent; i != NULL_NODE; i = m_nodes[static_cast<std::size_t>(i)].parent) {
+		i = balance(i);
+		refit(i);
+	}
+}
+
+// If the subtrees of node a differ in height by more than one, rotate the
+// taller child up into a's place. Return the node now at that position.
+int AABBTree::balance(int a) {
+	Node& A = m_nodes[static_cast<std::size_t>(a)];
+	if (A.isLeaf() || A.height < 2) return a;
+
+	const int b = A.child1;
+	const int c = A.child2;
+	const int diff = m_nodes[static_cast<std::size_t>(c)].height - m_nodes[static_cast<std::size_t>(b)].height;
+	if (diff >= -1 && diff <= 1) return a;
+
+	// Promote the taller child "up"; "keep" is the child left under a.
+	const int up = diff > 1 ? c : b;
+	Node& U = m_nodes[static_cast<std::size_t>(up)];
+	const int f = U.child1;
+	const int g = U.child2;
+
+	// up replaces a under a's parent, and a becomes a child of up.
+	U.child1 = a;
+	U.parent = A.parent;
+	A.parent = up;
+	if (U.parent == NULL_NODE) m_root = up;
+	else {
+		Node& P = m_nodes[static_cast<std::size_t>(U.parent)];
+		if (P.child1 == a) P.child1 = up;
+		else P.child2 = up;
+	}
+
+	// The taller grandchild stays with up; the shorter moves under a,
+	// into the slot up came from.
+	const bool f_taller = m_nodes[static_cast<std::size_t>(f)].height > m_nodes[static_cast<std::size_t>(g)].height;
+	const int stay = f_taller ? f : g;
+	const int move = f_taller ? g : f;
+	U.child2 = stay;
+	if (up == c) A.child2 = move;
+	else A.child1 = move;
+	m_nodes[static_cast<std::size_t>(move)].parent = a;
+
+	refit(a);
+	refit(up);
+	return up;
+}
+
+// Return fat box of proxy.
+Box AABBTree::getFatBox(int proxy) const {
+	const Node& n = m_nodes[static_cast<std::size_t>(proxy)];
+	return Box(Vector(n.min_x, n.min_y), n.max_x - n.min_x, n.max_y - n.min_y);
+}
+
+// Remove all proxies.
+void AABBTree::clear() {
+	m_nodes.clear();
+	m_root = NULL_NODE;
+	m_free = NULL_NODE;
+	m_leaf_count = 0;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <vector>
+#include "Box.h"
+
+class Object;
+
+
+// Dynamic bounding volume tree over Object boxes (broadphase).
+// Each Object is a leaf holding a "fat" box, its real box grown by a
+// margin, so small moves leave the tree untouched. Inserts pick the
+// sibling that least grows the tree's total perimeter and rotations keep
+// it height balanced, so queries cost O(log n) plus the hits.
+class AABBTree {
+public:
+	static const int NULL_NODE = -1;
+
+private:
+	struct Node {
+		float min_x, min_y, max_x, max_y; // Fat box of a leaf, union of children otherwise.
+		Object* p_object; // Leaf payload (nullptr for internal nodes).
+		int parent; // Parent node, or next free node while on the free list.
+		int child1, child2; // NULL_NODE for leaves.
+		int height; // 0 for leaves, -1 when free.
+
+		bool isLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	std::vector<Node> m_nodes;
+	int m_root;
+	int m_free; // Head of free node list.
+	int m_leaf_count;
+	float m_margin; // Fat box padding on every side.
+
+	int allocateNode();
+	void freeNode(int id);
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	int balance(int id);
+	void refit(int id); // Recompute box and height of node id from its children.
+
+	static bool overlaps(const Node& n, float min_x, float min_y, float max_x, float max_y) {
+		return n.min_x < max_x && min_x < n.max_x && n.min_y < max_y && min_y < n.max_y;
+	}
+
+public:
+	// Create empty tree. Fat boxes are padded by margin on every side.
+	explicit AABBTree(float margin = 1.0f);
+
+
+	// Add Object with box. Return its proxy id.
+	int insert(Object* p_o, const Box& box);
+
+
+	// Remove proxy.
+	void remove(int proxy);
+
+
+	// Update proxy to box after moving by displacement. The leaf is only
+	// reinserted if box escapes its fat box; the new fat box is stretched
+	// in the direction of travel. Return true if reinserted.
+	bool move(int proxy, const Box& box, const Vector& displacement);
+
+
+	// Call visit(Object*) for every proxy whose fat box overlaps box.
+	// These are candidates only; callers test the real boxes. visit must
+	// not change the tree.
+	template <class F>
+	void query(const Box& box, F&& visit) const {
+		if (m_root == NULL_NODE) return;
+		const float min_x = box.getCorner().getX(), min_y = box.getCorner().getY();
+		const float max_x = min_x + box.getHorizontal(), max_y = min_y + box.getVertical();
+
+		// Balanced trees rarely need more than the local stack.
+		const int LOCAL = 64;
+		int stack[LOCAL];
+		int top = 0;
+		std::vector<int> spill;
+		stack[top++] = m_root;
+		while (top > 0 || !spill.empty()) {
+			int id;
+			if (!spill.empty()) { id = spill.back(); spill.pop_back(); }
+			else id = stack[--top];
+
+			const Node& n = m_nodes[static_cast<std::size_t>(id)];
+			if (!overlaps(n, min_x, min_y, max_x, max_y)) continue;
+			if (n.isLeaf()) { visit(n.p_object); continue; }
+			if (top + 2 <= LOCAL) { stack[top++] = n.child1; stack[top++] = n.child2; }
+			else { spill.push_back(n.child1); spill.push_back(n.child2); }
+		}
+	}
+
+
+	// Return fat box of proxy.
+	Box getFatBox(int proxy) const;
+
+
+	// Return count of proxies.
+	int getCount() const { return m_leaf_count; }
+
+
+	// Return height of tree (0 for a single leaf, -1 if empty).
+	int getHeight() const { return m_root == NULL_NODE ? -1 : m_nodes[static_cast<std::size_t>(m_root)].height; }
+
+
+	// Remove all proxies.
+	void clear();
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include "Vector.h"
+
+
+// Axis-aligned rectangle: top-left corner plus horizontal and vertical
+// extents, in world (character cell) units.
+class Box {
+private:
+	Vector m_corner; // Top-left corner.
+	float m_horizontal; // Width.
+	float m_vertical; // Height.
+
+
+public:
+	// Create Box with corner (0,0) and no extent.
+	Box() : m_horizontal(0.0f), m_vertical(0.0f) {}
+
+
+	// Create Box with corner and extents.
+	Box(Vector corner, float horizontal, float vertical)
+		: m_corner(corner), m_horizontal(horizontal), m_vertical(vertical) {}
+
+
+	// Get/set top-left corner.
+	void setCorner(Vector corner) { m_corner = corner; }
+	Vector getCorner() const { return m_corner; }
+
+
+	// Get/set extents.
+	void setHorizontal(float horizontal) { m_horizontal = horizontal; }
+	float getHorizontal() const { return m_horizontal; }
+	void setVertical(float vertical) { m_vertical = vertical; }
+	float getVertical() const { return m_vertical; }
+
+
+	// True if the interiors overlap (boxes that only share an edge don't).
+	bool intersects(const Box& other) const {
+		return m_corner.getX() < other.m_corner.getX() + other.m_horizontal
+			&& other.m_corner.getX() < m_corner.getX() + m_horizontal
+			&& m_corner.getY() < other.m_corner.getY() + other.m_vertical
+			&& other.m_corner.getY() < m_corner.getY() + m_vertical;
+	}
+};
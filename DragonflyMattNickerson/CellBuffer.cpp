@@ -0,0 +1,31 @@
+#include "CellBuffer.h"
+
+#include <algorithm>
+
+void CellBuffer::resize(int cols, int rows) {
+	m_cols = cols > 0 ? cols : 0;
+	m_rows = rows > 0 ? rows : 0;
+	const std::size_t n = static_cast<std::size_t>(m_cols) * m_rows;
+	m_back.assign(n, BLANK);
+	m_changed.clear();
+	m_changed.reserve(n);
+	m_front.resize(n);
+	invalidate();
+}
+
+// No real cell packs to all ones, so every cell differs from the front.
+void CellBuffer::invalidate() {
+	std::fill(m_front.begin(), m_front.end(), static_cast<Cell>(~BLANK));
+}
+
+int CellBuffer::present() {
+	m_changed.clear();
+	const int n = static_cast<int>(m_back.size());
+	for (int i = 0; i < n; i++) {
+		if (m_back[static_cast<std::size_t>(i)] != m_front[static_cast<std::size_t>(i)])
+			m_changed.push_back(i);
+	}
+	m_front.swap(m_back);
+	std::fill(m_back.begin(), m_back.end(), BLANK);
+	return static_cast<int>(m_changed.size());
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Color.h"
+
+// Double-buffered character grid. Each cell packs a glyph and a color
+// into 16 bits. Drawing writes into the back grid; present() diffs it
+// against the front grid, reports which cells changed, and swaps.
+class CellBuffer {
+public:
+	using Cell = std::uint16_t;
+	static constexpr Cell BLANK = 0;
+
+	// Pack a glyph and color into a cell. Spaces become BLANK so that
+	// recoloring empty cells never counts as a change, and unknown colors
+	// draw as the default.
+	static Cell pack(char ch, df::Color color) {
+		if (ch == ' ' || ch == '\0') return BLANK;
+		if (color < df::BLACK || color > df::WHITE) color = df::COLOR_DEFAULT;
+		return static_cast<Cell>((static_cast<unsigned>(color) & 0xFF) << 8 | static_cast<unsigned char>(ch));
+	}
+	static char glyphOf(Cell c) { return c == BLANK ? ' ' : static_cast<char>(c & 0xFF); }
+	static df::Color colorOf(Cell c) { return static_cast<df::Color>(c >> 8); }
+
+private:
+	int m_cols{ 0 };
+	int m_rows{ 0 };
+	std::vector<Cell> m_front; // Last presented frame.
+	std::vector<Cell> m_back;  // Frame being drawn.
+	std::vector<int> m_changed; // Cell indices that differed at the last present().
+
+public:
+	// Resize both grids to cols x rows and blank them. Every cell is
+	// reported as changed at the next present().
+	void resize(int cols, int rows);
+
+	// Write a cell into the back grid. Return 0 ok, -1 if off the grid.
+	int put(int x, int y, Cell c) {
+		if (x < 0 || y < 0 || x >= m_cols || y >= m_rows) return -1;
+		m_back[static_cast<std::size_t>(y) * m_cols + x] = c;
+		return 0;
+	}
+
+	// Mark every cell as changed for the next present() without
+	// touching what has been drawn into the back grid.
+	void invalidate();
+
+	// Diff back against front, swap, and blank the new back grid.
+	// Return the number of changed cells.
+	int present();
+
+	// Cells that changed at the last present(), in row-major order.
+	const std::vector<int>& getChanged() const { return m_changed; }
+
+	// Cell at index i of the last presented frame.
+	Cell getFront(int i) const { return m_front[static_cast<std::size_t>(i)]; }
+
+	int getCols() const { return m_cols; }
+	int getRows() const { return m_rows; }
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include "CellBuffer.h"
+
+// Where DisplayManager sends finished frames. A backend turns the cells
+// that changed since the previous frame into output (window, terminal, ...).
+class DisplayBackend {
+public:
+    virtual ~DisplayBackend() = default;
+
+    // Open output for a cols x rows character grid. Pixel size is a hint
+    // that character-only backends ignore. Return 0 ok else -1.
+    virtual int open(int cols, int rows, int pixels_w, int pixels_h) = 0;
+
+    // Release output. Safe to call when not open.
+    virtual void close() = 0;
+
+    // Grid or pixel size changed while open. Return 0 ok else -1.
+    virtual int resize(int cols, int rows, int pixels_w, int pixels_h) = 0;
+
+    // Output one frame. cells.getChanged() lists the cells that differ
+    // from the previous frame; getFront() holds their new contents.
+    // Return 0 ok else -1.
+    virtual int present(const CellBuffer& cells) = 0;
+};
@@ -2,14 +2,16 @@
 #include "LogManager.h"
 #include "Color.h"  
 #include "Event.h"
-const char* WINDOW_TITLE_DEFAULT = "Dragonfly";
-const char* FONT_FILE_DEFAULT = "df-font.ttf";
-
-DisplayManager::DisplayManager()
-	: m_text(m_font, "", 30)
-{
+#include "TerminalDisplayBackend.h"
+#include "TraceManager.h"
+#include "WorldManager.h"
+#ifndef DF_NO_SFML
+#include "SFMLDisplayBackend.h"
+#endif
+
+DisplayManager::DisplayManager() {
     setType("DisplayManager");
-	m_text.setFont(m_font);
+    resizeGrid();
 }
 
 DisplayManager& DisplayManager::getInstance() {
@@ -21,46 +23,24 @@ DisplayManager& DisplayManager::getInstance() {
 int DisplayManager::startUp() {
     if (isStarted()) return 0;
 
-    // Create window
-    const sf::Vector2u size(
-        static_cast<unsigned>(m_window_horizontal_pixels),
-        static_cast<unsigned>(m_window_vertical_pixels));
-
-    const sf::VideoMode mode(size); 
-
-    m_p_window = new sf::RenderWindow(
-        mode,
-        WINDOW_TITLE_DEFAULT,
-        WINDOW_STYLE_DEFAULT);
-
-    if (!m_p_window || !m_p_window->isOpen()) {
-        df::LogManager::getInstance().writeLog("DisplayManager: window creation failed\n");
-        return -1;
+    if (!m_p_backend) {
+#ifdef DF_NO_SFML
+        m_p_backend = std::make_unique<TerminalDisplayBackend>();
+#else
+        m_p_backend = std::make_unique<SFMLDisplayBackend>();
+#endif
     }
 
-    // Load font
-    if (!m_font.openFromFile(FONT_FILE_DEFAULT)) {
-        df::LogManager::getInstance().writeLog("DisplayManager: failed to open font '%s'\n", FONT_FILE_DEFAULT);
-        delete m_p_window;
-        m_p_window = nullptr;
+    if (m_p_backend->open(m_window_horizontal_chars, m_window_vertical_chars,
+        m_window_horizontal_pixels, m_window_vertical_pixels) != 0) {
+        df::LogManager::getInstance().writeLog(df::LOG_ERROR, df::LOG_DISPLAY, "DisplayManager: backend failed to open\n");
         return -1;
     }
-
-    // Prepare text object sized to grid
-    const float approx_px_per_char =
-        static_cast<float>(m_window_vertical_pixels) / m_window_vertical_chars;
-    m_text.setFont(m_font);
-    m_text.setCharacterSize(static_cast<unsigned int>(approx_px_per_char));
-
-    // Derive cell sizes (monospace assumed)
-    m_cell_w = static_cast<float>(m_window_horizontal_pixels) / m_window_horizontal_chars;
-    m_cell_h = static_cast<float>(m_window_vertical_pixels) / m_window_vertical_chars;
-
-    m_p_window->clear(WINDOW_BACKGROUND_COLOR_DEFAULT);
+    m_cells.invalidate();
 
 	// Finish up
     df::Manager::startUp();
-    df::LogManager::getInstance().writeLog(
+    df::LogManager::getInstance().writeLog(df::LOG_INFO, df::LOG_ENGINE,
         "DisplayManager started (%dx%d px, %dx%d chars)\n",
         m_window_horizontal_pixels, m_window_vertical_pixels,
         m_window_horizontal_chars, m_window_vertical_chars);
@@ -68,45 +48,38 @@ int DisplayManager::startUp() {
 }
 // Shutdown.
 void DisplayManager::shutDown() {
-    df::LogManager::getInstance().writeLog("DisplayManager shutting down\n");
-    if (m_p_window) {
-        m_p_window->close();
-        delete m_p_window;
-        m_p_window = nullptr;
-    }
+    df::LogManager::getInstance().writeLog(df::LOG_INFO, df::LOG_ENGINE, "DisplayManager shutting down\n");
+    if (m_p_backend) m_p_backend->close();
     df::Manager::shutDown();
 }
 
-// Convert df::Color to sf::Color.
-sf::Color DisplayManager::toSF(df::Color c) const {
-    return df::toSFColor(c);
+// Replace the backend. Only allowed before startUp().
+int DisplayManager::setBackend(std::unique_ptr<DisplayBackend> p_backend) {
+    if (isStarted() || !p_backend) return -1;
+    m_p_backend = std::move(p_backend);
+    return 0;
 }
 
-// Convert grid coordinates to pixel coordinates (top-left of cell).
-sf::Vector2f DisplayManager::gridToPixels(const Vector& grid_xy) const {
-    // Top-left of the grid cell
-    return sf::Vector2f(grid_xy.getX() * m_cell_w, grid_xy.getY() * m_cell_h);
+// Resize the cell grid (forcing a full repaint) and tell an open backend.
+void DisplayManager::resizeGrid() {
+    m_cells.resize(m_window_horizontal_chars, m_window_vertical_chars);
+    if (isStarted())
+        m_p_backend->resize(m_window_horizontal_chars, m_window_vertical_chars,
+            m_window_horizontal_pixels, m_window_vertical_pixels);
 }
 
 // Draw single character at grid location with color. Return 0 ok else -1.
+// Only records the cell; swapBuffers() hands changed cells to the backend.
 int DisplayManager::drawCh(Vector grid_pos, char ch, df::Color color) const {
-    if (!m_p_window) return -1;
-	m_text.setFont(m_font);
-    m_text.setString(sf::String(ch));
-    m_text.setFillColor(toSF(color));
-
-    sf::Vector2f px = gridToPixels(grid_pos);
-    px.y += (m_cell_h * 0.1f);
-    m_text.setPosition(px);
-
-    m_p_window->draw(m_text);
-    return 0;
+    if (!isStarted()) return -1;
+    return m_cells.put(static_cast<int>(grid_pos.getX()), static_cast<int>(grid_pos.getY()),
+        CellBuffer::pack(ch, color));
 }
 
 // Draw string at grid location with justification and color.
 int DisplayManager::drawString(Vector grid_pos, const std::string& str,
     Justify just, df::Color color) const {
-    if (!m_p_window) return -1;
+    if (!isStarted()) return -1;
     if (str.empty())   return 0;
 
     int start_x = static_cast<int>(grid_pos.getX());
@@ -126,45 +99,34 @@ int DisplayManager::drawString(Vector grid_pos, const std::string& str,
     return 0;
 }
 
-// Swap front and back buffers.
-int DisplayManager::swapBuffers() {
-    if (!m_p_window) return -1;
-
+// Draw at world location: the WorldManager view maps it to a grid cell.
+int DisplayManager::drawChWorld(Vector world_pos, char ch, df::Color color) const {
+    return drawCh(WM().worldToView(world_pos), ch, color);
+}
+int DisplayManager::drawStringWorld(Vector world_pos, const std::string& str,
+    Justify just, df::Color color) const {
+    return drawString(WM().worldToView(world_pos), str, just, color);
+}
 
-    m_p_window->display();
-    m_p_window->clear(WINDOW_BACKGROUND_COLOR_DEFAULT);
-    return 0;
+// Swap front and back buffers: diff this frame against the last one and
+// let the backend re-emit only the changed cells.
+int DisplayManager::swapBuffers() {
+    if (!isStarted()) return -1;
+    df::TraceScope trace("DisplayManager::swapBuffers");
+    m_cells.present();
+    return m_p_backend->present(m_cells);
 }
 
 // Set grid size (cols, rows). If <= 0, keep current.
 void DisplayManager::setGridSize(int cols, int rows) {
     if (cols > 0) m_window_horizontal_chars = cols;
     if (rows > 0) m_window_vertical_chars = rows;
-
-    m_cell_w = static_cast<float>(m_window_horizontal_pixels) / m_window_horizontal_chars;
-    m_cell_h = static_cast<float>(m_window_vertical_pixels) / m_window_vertical_chars;
-
-    const float approx_px_per_char =
-        static_cast<float>(m_window_vertical_pixels) / m_window_vertical_chars;
-    m_text.setCharacterSize(static_cast<unsigned int>(approx_px_per_char));
+    resizeGrid();
 }
 
 // Set pixel size (width, height). If <= 0, keep current.
 void DisplayManager::setPixelSize(int w, int h) {
     if (w > 0) m_window_horizontal_pixels = w;
     if (h > 0) m_window_vertical_pixels = h;
-
-    if (m_p_window) {
-        const sf::Vector2u size(
-            static_cast<unsigned>(m_window_horizontal_pixels),
-            static_cast<unsigned>(m_window_vertical_pixels));
-
-        const sf::VideoMode mode(size); // or (size, 32)
-
-        m_p_window->create(mode, WINDOW_TITLE_DEFAULT, WINDOW_STYLE_DEFAULT);
-    }
-
-    const float approx_px_per_char =
-        static_cast<float>(m_window_vertical_pixels) / m_window_vertical_chars;
-    m_text.setCharacterSize(static_cast<unsigned int>(approx_px_per_char));
+    resizeGrid();
 }
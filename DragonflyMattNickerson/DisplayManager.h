@@ -1,16 +1,17 @@
 #pragma once
-#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
 #include "Manager.h"
 #include "Vector.h"
 #include "Color.h"  
+#include "CellBuffer.h"
+#include "DisplayBackend.h"
 
-// Defaults for SFML window.
+// Defaults for the display.
 constexpr int  WINDOW_HORIZONTAL_PIXELS_DEFAULT = 1024;
 constexpr int  WINDOW_VERTICAL_PIXELS_DEFAULT = 768;
 constexpr int  WINDOW_HORIZONTAL_CHARS_DEFAULT = 80;
 constexpr int  WINDOW_VERTICAL_CHARS_DEFAULT = 24;
-constexpr auto WINDOW_STYLE_DEFAULT = sf::Style::Titlebar;
-const sf::Color WINDOW_BACKGROUND_COLOR_DEFAULT = sf::Color::Black;
 
 
 enum class Justify { LEFT, CENTER, RIGHT };
@@ -21,28 +22,32 @@ private:
     DisplayManager(const DisplayManager&) = delete;
     DisplayManager& operator=(const DisplayManager&) = delete;
 
-    sf::Font          m_font;
-    sf::RenderWindow* m_p_window{ nullptr };
+    std::unique_ptr<DisplayBackend> m_p_backend; // Where frames go.
 
     int   m_window_horizontal_pixels{ WINDOW_HORIZONTAL_PIXELS_DEFAULT };
     int   m_window_vertical_pixels{ WINDOW_VERTICAL_PIXELS_DEFAULT };
     int   m_window_horizontal_chars{ WINDOW_HORIZONTAL_CHARS_DEFAULT };
     int   m_window_vertical_chars{ WINDOW_VERTICAL_CHARS_DEFAULT };
-    float m_cell_w{ 0.f };
-    float m_cell_h{ 0.f };
 
-    // helpers
-    sf::Color     toSF(df::Color c) const;                      
-    sf::Vector2f  gridToPixels(const Vector& grid_xy) const;
-    mutable sf::Text m_text; // Reusable text object for drawing.
+    // Characters drawn this frame and the last presented frame.
+    mutable CellBuffer m_cells;
+
+    // Resize the cell grid and tell an open backend.
+    void resizeGrid();
 
 public:
     static DisplayManager& getInstance();
 
+    // Open the backend (SFML window by default, or the terminal when
+    // built with DF_NO_SFML).
     int  startUp() override;
     void shutDown() override;
 
-    // Draw single character at grid location with color. Return 0 ok else -1.
+    // Replace the backend. Only allowed before startUp(). Return 0 ok else -1.
+    int setBackend(std::unique_ptr<DisplayBackend> p_backend);
+    DisplayBackend* getBackend() const { return m_p_backend.get(); }
+
+    // Draw single character at grid (screen) location with color. Return 0 ok else -1.
     int drawCh(Vector grid_pos, char ch, df::Color color) const; 
 
     // Without color (defaults to white).
@@ -50,7 +55,7 @@ public:
         return drawCh(grid_pos, ch, df::COLOR_DEFAULT);        
     }
 
-    // Draw string at grid location with justification and color.
+    // Draw string at grid (screen) location with justification and color.
     int drawString(Vector grid_pos, const std::string& str,
         Justify just, df::Color color) const;        // <-- df::Color
 
@@ -58,15 +63,31 @@ public:
         return drawString(grid_pos, str, just, df::COLOR_DEFAULT);
     }
 
+    // Same at a world location, mapped to the screen through the
+    // WorldManager view (for Objects; HUD text uses the grid versions).
+    // Return 0 ok else -1 (including when off screen).
+    int drawChWorld(Vector world_pos, char ch, df::Color color) const;
+    int drawChWorld(Vector world_pos, char ch) const {
+        return drawChWorld(world_pos, ch, df::COLOR_DEFAULT);
+    }
+    int drawStringWorld(Vector world_pos, const std::string& str,
+        Justify just, df::Color color) const;
+    int drawStringWorld(Vector world_pos, const std::string& str, Justify just) const {
+        return drawStringWorld(world_pos, str, just, df::COLOR_DEFAULT);
+    }
+
+    // Present this frame's cells (only changed cells are re-emitted) and
+    // start a new, blank frame.
     int swapBuffers();
 
+    // Number of cells that differed from the previous frame at the last swapBuffers().
+    int getChangedCellCount() const { return static_cast<int>(m_cells.getChanged().size()); }
+
     int getHorizontal() const { return m_window_horizontal_chars; }
     int getVertical()   const { return m_window_vertical_chars; }
     int getHorizontalPixels() const { return m_window_horizontal_pixels; }
     int getVerticalPixels()   const { return m_window_vertical_pixels; }
 
-    sf::RenderWindow* getWindow() const { return m_p_window; }
-
     void setGridSize(int cols, int rows);
     void setPixelSize(int w, int h);
 };
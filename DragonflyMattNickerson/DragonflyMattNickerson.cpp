@@ -1,25 +1,40 @@
+#include <atomic>
 #include <cmath>
 #include <thread>
 #include <chrono>
 #include <stdexcept>
 #include <vector>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <string>
 
 #include "LogManager.h"
 #include "WorldManager.h"
 #include "GameManager.h"
 #include "InputManager.h"
+#include "JobManager.h"
+#include "FrameProfiler.h"
+#include "TraceManager.h"
 #include "DisplayManager.h"
+#include "TerminalDisplayBackend.h"
+#include "TransformStore.h"
 
 #include "Vector.h"
 #include "Object.h"
 #include "ObjectList.h"
+#include "ObjectListView.h"
+#include "SmallObjectList.h"
 #include "EventStep.h"
 #include "EventOut.h"
 #include "EventCollision.h"
 #include "EventKeyboard.h"
 #include "EventMouse.h"
 #include "Clock.h"
+#include "FramePacer.h"
+#include "PoolAllocator.h"
+#include "AABBTree.h"
 
 // ====== Test Config ======
 #define RUN_MANUAL_INPUT_TEST 0  // set to 1 to manually test keyboard/mouse
@@ -60,6 +75,24 @@ static void test_Clock() {
     TEST_ASSERT(s1 >= 1500, "split() >= ~1.5ms after sleep(2ms)");
 }
 
+// ---------- FramePacer tests ----------
+static void test_FramePacer() {
+    df::LogManager::getInstance().writeLog("== FramePacer tests ==\n");
+    df::FramePacer pacer(2000); // 2 ms frames
+    df::Clock c;
+    pacer.start();
+    for (int i = 0; i < 50; ++i) {
+        if (i == 10) sleep_ms(3); // one overrun must not shift the schedule
+        pacer.wait();
+    }
+    const long long elapsed = c.split();
+    const df::FramePacer::Stats st = pacer.getStats();
+    TEST_ASSERT(elapsed >= 100000 && elapsed < 150000, "50 paced 2ms frames take ~100ms (no drift)");
+    TEST_ASSERT(st.frames + st.overruns == 50 && st.overruns >= 1, "pacer counts overrun frames");
+    df::LogManager::getInstance().writeLog("pacer: late mean %.1f us, jitter %.1f us, max %.1f us\n",
+        st.mean_late_us, st.jitter_us, st.max_late_us);
+}
+
 // ---------- Object & ObjectList tests ----------
 class DummyObj : public Object {
 public:
@@ -103,6 +136,33 @@ static void test_Object_and_ObjectList() {
     TEST_ASSERT(L.remove(a) == -1, "remove() non-existent returns -1");
     L.clear(); TEST_ASSERT(L.getCount() == 0, "clear() empties list");
 
+    // Handles resolve in O(1) and go stale on removal, even if the slot is reused
+    ObjectHandle ha = L.insertHandle(a);
+    TEST_ASSERT(L.get(ha) == a, "handle resolves to inserted object");
+    TEST_ASSERT(L.remove(ha) == 0 && L.get(ha) == nullptr, "handle stale after remove()");
+    ObjectHandle hb = L.insertHandle(b);
+    TEST_ASSERT(hb.index == ha.index && L.get(ha) == nullptr && L.get(hb) == b, "reused slot does not revive stale handle");
+    L.clear(); TEST_ASSERT(L.get(hb) == nullptr, "clear() invalidates handles");
+
+    // List grows past the old fixed capacity
+    for (int i = 0; i < 5000; ++i) L.insert(a);
+    TEST_ASSERT(L.getCount() == 5000, "ObjectList grows past 1000 entries");
+    L.clear();
+
+    // Views iterate without copying; small lists spill to the heap when full
+    L.insert(a); L.insert(b);
+    int visited = 0;
+    for (Object* o : ObjectListView(L)) if (o == a || o == b) ++visited;
+    TEST_ASSERT(visited == 2 && ObjectListView(L).getCount() == 2, "ObjectListView range-for visits all");
+    L.clear();
+    SmallObjectList<2> small;
+    small.insert(a); small.insert(b); small.insert(a);
+    TEST_ASSERT(small.getCount() == 3 && small[0] == a && small[1] == b && small[2] == a, "SmallObjectList spills past inline capacity");
+
+    // World handle follows the Object
+    ObjectHandle wa = a->getHandle();
+    TEST_ASSERT(WM().getObject(wa) == a, "WorldManager resolves Object handle");
+
     // WorldManager add/remove via Object helpers
     int before = WM().getAllObjects().getCount();
     DummyObj* c = new DummyObj(Vector(0.f, 0.f)); // auto add (if your Object() adds itself)
@@ -115,13 +175,15 @@ static void test_Object_and_ObjectList() {
 
     // cleanup
     a->markForDelete(); b->markForDelete(); WM().update();
+    TEST_ASSERT(WM().getObject(wa) == nullptr, "Object handle stale after deletion");
 }
 
 // ---------- WorldManager movement/bounds/collision ----------
 class CollisionProbe : public Object {
 public:
     int out_count = 0;
-    int col_count = 0;
+    int col_count = 0; // Collision begin (or stay) events.
+    int end_count = 0; // Collision end events.
 
     CollisionProbe(const char* t, const Vector& p, Solidness s) {
         setType(t);
@@ -132,17 +194,16 @@ public:
     }
 
     int onEvent(const Event& e) override {
-        if (auto* o = dynamic_cast<const EventOut*>(&e)) {
-            (void)o;
+        if (e.is<EventOut>()) {
             ++out_count;
-            df::LogManager::getInstance().writeLog("[CollisionProbe %s id=%d] OUT\n",
+            df::LogManager::getInstance().writeLog(df::LOG_DEBUG, df::LOG_GAME, "[CollisionProbe %s id=%d] OUT\n",
                 getType().c_str(), getId());
             return 1;
         }
-        if (auto* c = dynamic_cast<const EventCollision*>(&e)) {
-            (void)c;
+        if (const EventCollision* c = e.as<EventCollision>()) {
+            if (c->getPhase() == CollisionPhase::END) { ++end_count; return 1; }
             ++col_count;
-            df::LogManager::getInstance().writeLog("[CollisionProbe %s id=%d] COLLISION\n",
+            df::LogManager::getInstance().writeLog(df::LOG_DEBUG, df::LOG_GAME, "[CollisionProbe %s id=%d] COLLISION\n",
                 getType().c_str(), getId());
             return 1;
         }
@@ -179,6 +240,22 @@ static void test_WorldManager_features() {
         TEST_ASSERT(WM().getAllObjects().getCount() == 0, "world cleared");
     }
 
+    // objectsOfType() reads per-type buckets kept current by setType()
+    {
+        CollisionProbe* A1 = new CollisionProbe("TypeA", Vector(1, 1), Solidness::SPECTRAL);
+        CollisionProbe* A2 = new CollisionProbe("TypeA", Vector(2, 1), Solidness::SPECTRAL);
+        CollisionProbe* B = new CollisionProbe("TypeB", Vector(3, 1), Solidness::SPECTRAL);
+        TEST_ASSERT(WM().objectsOfType("TypeA").getCount() == 2 && WM().objectsOfType("TypeB").getCount() == 1,
+            "objectsOfType() counts per type");
+        TEST_ASSERT(A1->getTypeId() == A2->getTypeId() && A1->getTypeId() != B->getTypeId(), "interned type ids compare");
+        A2->setType("TypeB");
+        TEST_ASSERT(WM().objectsOfType("TypeA").getCount() == 1 && WM().objectsOfType(B->getTypeId()).getCount() == 2,
+            "setType() moves Object between type buckets");
+        TEST_ASSERT(WM().objectsOfType("NoSuchType").getCount() == 0, "objectsOfType() unknown type is empty");
+        A1->markForDelete(); A2->markForDelete(); B->markForDelete(); WM().update();
+        TEST_ASSERT(WM().objectsOfType("TypeB").getCount() == 0, "deleted Objects leave type buckets");
+    }
+
     // 1) Out-of-bounds generates EventOut and blocks movement
     {
         CollisionProbe* edge = new CollisionProbe("Edge", Vector(0, 0), Solidness::HARD);
@@ -211,7 +288,36 @@ static void test_WorldManager_features() {
         A->markForDelete(); B->markForDelete(); WM().update();
     }
 
-    // 4) Draw order by altitude (lowest first)
+    // 4) Spatial grid follows setPosition() teleports
+    {
+        CollisionProbe* A = new CollisionProbe("A", Vector(2, 2), Solidness::HARD);
+        CollisionProbe* B = new CollisionProbe("B", Vector(30, 20), Solidness::HARD);
+        B->setPosition(Vector(3, 2));
+        A->setVelocityX(+1.f);
+        WM().update();
+        TEST_ASSERT(A->col_count >= 1 && B->col_count >= 1, "collision found after setPosition() moved cell");
+        TEST_ASSERT(static_cast<int>(A->getPosition().getX()) == 2, "teleported HARD object blocks mover");
+        A->markForDelete(); B->markForDelete(); WM().update();
+    }
+
+    // 5) Vectorized integration moves every mover by its own velocity
+    {
+        std::vector<CollisionProbe*> movers;
+        for (int i = 0; i < 37; ++i) {  // not a multiple of the SIMD width
+            CollisionProbe* m = new CollisionProbe("Mover", Vector(1.f, static_cast<float>(i % 20)), Solidness::SPECTRAL);
+            m->setVelocity(static_cast<float>(i % 3), 0.f);
+            movers.push_back(m);
+        }
+        WM().update();
+        bool all_moved = true;
+        for (int i = 0; i < 37; ++i)
+            all_moved = all_moved && std::fabs(movers[i]->getPosition().getX() - (1.f + static_cast<float>(i % 3))) < 1e-5f;
+        TEST_ASSERT(all_moved, "integration pass advanced all movers by velocity");
+        for (CollisionProbe* m : movers) m->markForDelete();
+        WM().update();
+    }
+
+    // 6) Draw order by altitude (lowest first)
     {
         DrawProbe::seen_ids.clear();
         DrawProbe* low = new DrawProbe(0, Vector(1, 1));
@@ -220,7 +326,29 @@ static void test_WorldManager_features() {
         WM().draw();
 
         TEST_ASSERT(DrawProbe::seen_ids.size() == 3, "draw() visited 3 objects");
+        TEST_ASSERT(DrawProbe::seen_ids == std::vector<int>({ low->getId(), mid->getId(), high->getId() }),
+            "draw() visits lowest altitude first");
+
+        DrawProbe::seen_ids.clear();
+        mid->setAltitude(20);
+        WM().draw();
+        TEST_ASSERT(DrawProbe::seen_ids == std::vector<int>({ low->getId(), high->getId(), mid->getId() }),
+            "setAltitude() moves Object to its new draw bucket");
         low->markForDelete(); mid->markForDelete(); high->markForDelete(); WM().update();
+
+        // Within an altitude: id order, even after a removal swaps the
+        // bucket and an older Object arrives from another altitude.
+        std::vector<DrawProbe*> same;
+        for (int i = 0; i < 5; ++i) same.push_back(new DrawProbe(i == 0 ? 1 : 2, Vector(static_cast<float>(i), 3)));
+        same[1]->markForDelete();
+        WM().update();
+        same[0]->setAltitude(2);
+        DrawProbe::seen_ids.clear();
+        WM().draw();
+        TEST_ASSERT(DrawProbe::seen_ids == std::vector<int>({ same[0]->getId(), same[2]->getId(), same[3]->getId(), same[4]->getId() }),
+            "draw() keeps id order within an altitude");
+        for (int i : { 0, 2, 3, 4 }) same[static_cast<std::size_t>(i)]->markForDelete();
+        WM().update();
     }
 }
 
@@ -231,12 +359,13 @@ class StepProbe : public Object {
 public:
     explicit StepProbe(int steps) : limit(steps) {
         setType("StepProbe");
+        registerInterest(EventStep::TYPE_ID);
     }
 
     int onEvent(const Event& e) override {
-        if (auto* s = dynamic_cast<const EventStep*>(&e)) {
+        if (auto* s = e.as<EventStep>()) {
             ++seen;
-            df::LogManager::getInstance().writeLog(
+            df::LogManager::getInstance().writeLog(df::LOG_DEBUG, df::LOG_GAME,
                 "[StepProbe %d] saw step=%d\n", getId(), s->getStepCount());
             if (seen >= limit) df::GameManager::getInstance().setGameOver(true);
             return 1;
@@ -247,6 +376,594 @@ public:
     int getSeen() const { return seen; }
 };
 
+// Opts in to parallel steps; records the order its deferred work is applied in.
+class ParallelStepper : public Object {
+public:
+    static std::vector<int> applied;
+    static std::atomic<bool> saw_retype; // A handler saw its setType() before the batch ended.
+    int steps = 0;
+    explicit ParallelStepper(const Vector& p) {
+        setType("ParallelStepper");
+        setPosition(p);
+        setSolidness(Solidness::SPECTRAL);
+        setParallelStep();
+        registerInterest(EventStep::TYPE_ID);
+    }
+    int onEvent(const Event& e) override {
+        if (!e.is<EventStep>()) return 0;
+        ++steps;
+        setPosition(Vector(getPosition().getX() + 1.f, getPosition().getY()));
+        const int id = getId();
+        setType("ParallelStepper" + std::to_string(id % 4)); // new type names, interned after the batch
+        if (getType() != "ParallelStepper") saw_retype = true;
+        df::JobManager::defer([id] { applied.push_back(id); });
+        markForDelete();
+        return 1;
+    }
+};
+std::vector<int> ParallelStepper::applied;
+std::atomic<bool> ParallelStepper::saw_retype{ false };
+
+static void test_parallel_step() {
+    df::LogManager::getInstance().writeLog("== Parallel step dispatch test ==\n");
+    std::vector<ParallelStepper*> objs;
+    for (int i = 0; i < 500; ++i) objs.push_back(new ParallelStepper(Vector(static_cast<float>(i % 70), static_cast<float>(i % 20))));
+
+    ParallelStepper::applied.clear();
+    const int sent = df::GameManager::getInstance().onEvent(EventStep(0));
+    bool all_ran = sent == 500, all_marked = true;
+    for (auto* o : objs) {
+        all_ran = all_ran && o->steps == 1;
+        all_marked = all_marked && o->isMarkedForDelete();
+    }
+    TEST_ASSERT(all_ran, "parallel step handlers each ran once");
+    TEST_ASSERT(all_marked, "markForDelete() from parallel handler applied after batch");
+
+    // Deferred work is applied in registration order (ids ascend with
+    // construction), not in whatever order the workers ran.
+    TEST_ASSERT(ParallelStepper::applied.size() == 500, "deferred work applied once per handler");
+    bool ordered = true;
+    for (std::size_t i = 1; i < ParallelStepper::applied.size(); ++i)
+        ordered = ordered && ParallelStepper::applied[i - 1] < ParallelStepper::applied[i];
+    TEST_ASSERT(ordered, "deferred work applied in deterministic order");
+    int retyped = 0;
+    for (int t = 0; t < 4; ++t) retyped += WM().objectsOfType("ParallelStepper" + std::to_string(t)).getCount();
+    TEST_ASSERT(!ParallelStepper::saw_retype && retyped == 500 && WM().objectsOfType("ParallelStepper").getCount() == 0,
+        "setType() from parallel handler (type interning included) applied after batch");
+    WM().update();
+    retyped = 0;
+    for (int t = 0; t < 4; ++t) retyped += WM().objectsOfType("ParallelStepper" + std::to_string(t)).getCount();
+    TEST_ASSERT(retyped == 0, "parallel-marked Objects deleted by update()");
+
+    // Back-to-back batches: a helper still stealing from one batch must
+    // not lose a chunk of the next (the caller would wait forever).
+    std::atomic<int> total{ 0 };
+    for (int b = 0; b < 2000; ++b)
+        df::JobManager::getInstance().parallelFor(4, [&total](int) { total.fetch_add(1, std::memory_order_relaxed); }, 1);
+    TEST_ASSERT(total.load() == 8000, "back-to-back parallelFor() batches all complete");
+}
+
+// ---------- View culling tests ----------
+// Only Objects under the view are drawn, through both the bucket walk
+// (small worlds) and the spatial query (many Objects per view cell).
+static void test_view_culling() {
+    df::LogManager::getInstance().writeLog("== View culling tests ==\n");
+    const Box old_view = WM().getView();
+    WM().setBoundary(400, 100);
+
+    std::vector<DrawProbe*> probes;
+    for (int i = 0; i < 200; ++i)
+        probes.push_back(new DrawProbe(i % 3, Vector(static_cast<float>(i * 2 % 400), static_cast<float>(i % 100))));
+    DrawProbe* wide = new DrawProbe(1, Vector(95, 52));
+    wide->setBox(Box(Vector(0, 0), 10, 1)); // reaches into the view from the left
+
+    auto expected = [&](const Box& view) {
+        std::size_t n = 0;
+        for (DrawProbe* p : probes) if (view.intersects(p->getWorldBox())) ++n;
+        return n + (view.intersects(wide->getWorldBox()) ? 1 : 0);
+    };
+    auto sorted_by_altitude = [] {
+        std::vector<int> alts;
+        for (int id : DrawProbe::seen_ids)
+            for (Object* o : WM().objectsOfType("DrawProbe")) if (o->getId() == id) alts.push_back(o->getAltitude());
+        return std::is_sorted(alts.begin(), alts.end());
+    };
+
+    const Box small(Vector(100, 50), 10, 5); // 50 cells < 201 Objects: spatial query
+    WM().setView(small);
+    DrawProbe::seen_ids.clear();
+    WM().draw();
+    const bool wide_seen = std::find(DrawProbe::seen_ids.begin(), DrawProbe::seen_ids.end(), wide->getId()) != DrawProbe::seen_ids.end();
+    TEST_ASSERT(DrawProbe::seen_ids.size() == expected(small) && wide_seen && sorted_by_altitude(),
+        "small view draws only visible Objects, in altitude order");
+
+    // Two Objects sharing a cell keep id order, even after the older one
+    // leaves the cell and comes back.
+    DrawProbe* under = new DrawProbe(7, Vector(105, 52));
+    DrawProbe* over = new DrawProbe(7, Vector(105, 52));
+    under->setPosition(Vector(106, 52));
+    under->setPosition(Vector(105, 52));
+    DrawProbe::seen_ids.clear();
+    WM().draw();
+    const std::vector<int> first = DrawProbe::seen_ids;
+    DrawProbe::seen_ids.clear();
+    WM().draw();
+    const auto at = [&first](int id) { return std::find(first.begin(), first.end(), id) - first.begin(); };
+    TEST_ASSERT(at(under->getId()) < at(over->getId()) && first == DrawProbe::seen_ids,
+        "small view draws a cell in id order, the same every frame");
+    under->markForDelete();
+    over->markForDelete();
+    WM().update();
+
+    const Box big(Vector(0, 0), 200, 50); // bucket walk
+    WM().setView(big);
+    DrawProbe::seen_ids.clear();
+    WM().draw();
+    TEST_ASSERT(DrawProbe::seen_ids.size() == expected(big) && expected(big) < probes.size() + 1,
+        "large view culls by box");
+
+    // A wall and a dot it overlaps keep their stacking (id order) when
+    // spawns push the world across the bucket-walk/spatial-query switch.
+    WM().setView(Box(Vector(150, 70), 21, 10)); // 210 cells
+    DrawProbe* wall = new DrawProbe(1, Vector(152, 72));
+    wall->setBox(Box(Vector(0, 0), 10, 1));
+    DrawProbe* dot = new DrawProbe(1, Vector(155, 72));
+    auto wall_first = [&] {
+        DrawProbe::seen_ids.clear();
+        WM().draw();
+        const auto& seen = DrawProbe::seen_ids;
+        const auto w = std::find(seen.begin(), seen.end(), wall->getId());
+        return w != seen.end() && std::find(w, seen.end(), dot->getId()) != seen.end();
+    };
+    const bool walked = WM().getAllObjects().getCount() <= 210 && wall_first();
+    std::vector<DrawProbe*> filler;
+    for (int i = 0; i < 10; ++i) filler.push_back(new DrawProbe(0, Vector(static_cast<float>(i), 0)));
+    TEST_ASSERT(walked && WM().getAllObjects().getCount() > 210 && wall_first(),
+        "overlapping Objects keep id order when the draw path switches");
+    for (DrawProbe* p : filler) p->markForDelete();
+    wall->markForDelete();
+    dot->markForDelete();
+    WM().update();
+
+    WM().setView(Box(Vector(0, 0), 80, 24));
+    WM().setViewPosition(Vector(395, 98));
+    const Vector corner = WM().getView().getCorner();
+    const Vector screen = WM().worldToView(Vector(330, 80));
+    TEST_ASSERT(corner.getX() == 320.f && corner.getY() == 76.f && screen.getX() == 10.f && screen.getY() == 4.f
+        && WM().viewToWorld(screen).getX() == 330.f, "view clamps to boundary and maps world to screen");
+    auto& DM = DisplayManager::getInstance();
+    TEST_ASSERT(DM.drawChWorld(Vector(10, 10), '#') == -1, "drawChWorld() off the view fails");
+
+    // HUD text is in screen space: it stays put when the view moves.
+    DM.drawString(Vector(1, 1), "HUD", Justify::LEFT);
+    DM.swapBuffers();
+    WM().setViewPosition(Vector(200, 50));
+    DM.drawString(Vector(1, 1), "HUD", Justify::LEFT);
+    DM.swapBuffers();
+    TEST_ASSERT(DM.getChangedCellCount() == 0, "screen-space text does not move with the view");
+    const Vector view_corner = WM().getView().getCorner();
+    TEST_ASSERT(DM.drawStringWorld(Vector(view_corner.getX() + 1, view_corner.getY() + 1), "HUD", Justify::LEFT) == 0,
+        "world-space text at the view corner lands on screen");
+    DM.swapBuffers();
+    TEST_ASSERT(DM.getChangedCellCount() == 0, "world-space text maps through the view");
+    DM.swapBuffers();
+
+    for (DrawProbe* p : probes) p->markForDelete();
+    wide->markForDelete();
+    WM().update();
+    WM().setBoundary(80, 24);
+    WM().setView(old_view);
+}
+
+// ---------- Contact tracking tests ----------
+// A resting contact sends one begin, an end once the pair separates, and
+// stay events only when asked for.
+static void test_contacts() {
+    df::LogManager::getInstance().writeLog("== Contact tracking tests ==\n");
+    const int contacts = WM().getContactCount();
+    CollisionProbe* A = new CollisionProbe("ContactA", Vector(5, 8), Solidness::HARD);
+    CollisionProbe* B = new CollisionProbe("ContactB", Vector(6, 8), Solidness::HARD);
+    A->setVelocityX(1);
+    for (int i = 0; i < 5; ++i) WM().update();
+    TEST_ASSERT(A->col_count == 1 && B->col_count == 1 && A->end_count == 0
+        && WM().getContactCount() == contacts + 1, "resting contact sends a single begin");
+
+    A->setVelocityX(0);
+    A->setPosition(Vector(2, 8));
+    WM().update();
+    TEST_ASSERT(A->end_count == 1 && B->end_count == 1 && WM().getContactCount() == contacts,
+        "separating sends end to both");
+
+    WM().setContactStay(true);
+    A->setPosition(Vector(5, 8));
+    A->setVelocityX(1);
+    for (int i = 0; i < 3; ++i) WM().update();
+    WM().setContactStay(false);
+    TEST_ASSERT(A->col_count == 4 && B->col_count == 4, "stay events sent every step when enabled");
+
+    // Spectral overlap at rest stays in contact without a move.
+    CollisionProbe* S = new CollisionProbe("ContactS", Vector(9, 8), Solidness::SPECTRAL);
+    S->setVelocityX(1);
+    WM().update(); // into B's neighbour cell 10: nothing there
+    S->setPosition(Vector(5, 9));
+    S->setVelocity(0, -1);
+    WM().update(); // onto A's cell
+    S->setVelocity(0, 0);
+    WM().update();
+    WM().update();
+    TEST_ASSERT(S->col_count == 1 && S->end_count == 0, "overlapping pair at rest stays in contact");
+
+    // Contacts with a deleted Object are dropped without an event.
+    S->markForDelete();
+    B->markForDelete();
+    WM().update(); // A still pushes B until B goes
+    WM().update();
+    TEST_ASSERT(A->end_count == 1 && WM().getContactCount() == contacts, "contacts with deleted Objects are dropped");
+    A->markForDelete();
+    WM().update();
+}
+
+// ---------- Collision tree / box tests ----------
+// Tree queries match brute force over random boxes, stay balanced, and
+// multi-cell boxes collide through WorldManager.
+static void test_AABBTree() {
+    df::LogManager::getInstance().writeLog("== AABB tree tests ==\n");
+    AABBTree tree(0.5f);
+    const int n = 2000;
+    std::vector<Box> boxes;
+    std::vector<int> proxies;
+    unsigned seed = 12345;
+    auto rnd = [&seed](int m) { seed = seed * 1103515245u + 12345u; return static_cast<int>((seed >> 16) % static_cast<unsigned>(m)); };
+    for (int i = 0; i < n; ++i) {
+        boxes.push_back(Box(Vector(static_cast<float>(rnd(1000)), static_cast<float>(rnd(1000))),
+            static_cast<float>(1 + rnd(8)), static_cast<float>(1 + rnd(8))));
+        // Objects are only used as tags here, never dereferenced.
+        proxies.push_back(tree.insert(reinterpret_cast<Object*>(static_cast<std::uintptr_t>(i + 1)), boxes.back()));
+    }
+    // Move half of them, most by a little and some far away.
+    for (int i = 0; i < n; i += 2) {
+        const float dx = static_cast<float>(i % 10 == 0 ? rnd(500) : rnd(3)) - 1.f;
+        Vector c = boxes[i].getCorner();
+        boxes[i].setCorner(Vector(c.getX() + dx, c.getY()));
+        tree.move(proxies[i], boxes[i], Vector(dx, 0));
+    }
+    for (int i = 1; i < n; i += 7) { tree.remove(proxies[i]); proxies[i] = -1; }
+
+    bool same = true;
+    for (int q = 0; q < 200 && same; ++q) {
+        const Box query(Vector(static_cast<float>(rnd(1000)), static_cast<float>(rnd(1000))), 20, 20);
+        std::vector<int> found;
+        tree.query(query, [&](Object* p) {
+            const int i = static_cast<int>(reinterpret_cast<std::uintptr_t>(p)) - 1;
+            if (query.intersects(boxes[i])) found.push_back(i);
+        });
+        std::vector<int> brute;
+        for (int i = 0; i < n; ++i) if (proxies[i] >= 0 && query.intersects(boxes[i])) brute.push_back(i);
+        std::sort(found.begin(), found.end());
+        same = found == brute;
+    }
+    TEST_ASSERT(same, "tree query matches brute force after moves and removes");
+    TEST_ASSERT(tree.getCount() == n - (n + 5) / 7 && tree.getHeight() <= 2 * 11 + 2, "tree stays balanced");
+}
+
+static void test_box_collisions() {
+    df::LogManager::getInstance().writeLog("== Box collision tests ==\n");
+    CollisionProbe* wall = new CollisionProbe("BoxWall", Vector(30, 15), Solidness::HARD);
+    wall->setBox(Box(Vector(0, 0), 10, 1)); // cells x 30..39
+    CollisionProbe* mover = new CollisionProbe("BoxMover", Vector(36, 13), Solidness::HARD);
+    mover->setVelocityY(1);
+    WM().update(); // 13 -> 14, still clear
+    WM().update(); // 14 -> 15 would land on the wall's 7th cell
+    TEST_ASSERT(mover->getPosition().getY() == 14.f && mover->col_count == 1 && wall->col_count == 1,
+        "one-cell mover collides with a wide wall away from its origin");
+
+    mover->setVelocity(0, 0);
+    CollisionProbe* big = new CollisionProbe("BoxBig", Vector(40, 10), Solidness::HARD);
+    big->setBox(Box(Vector(-1, -1), 3, 3)); // cells 39..41 x 9..11
+    mover->setPosition(Vector(37, 10));
+    big->setVelocityX(-1);
+    WM().update(); // big to 39 covers 38..40: clear of the mover at 37
+    WM().update(); // big to 38 covers 37..39: hits the mover
+    TEST_ASSERT(big->getPosition().getX() == 39.f && mover->col_count == 2, "large sprite collides by box");
+
+    wall->markForDelete(); mover->markForDelete(); big->markForDelete();
+    WM().update();
+}
+
+// ---------- Pool allocator tests ----------
+// Pooled Objects come from a per-type slab; deferred deletion gives the
+// blocks back in one batch and the next wave reuses them.
+class PooledProbe : public Object, public df::Pooled<PooledProbe> {
+public:
+    explicit PooledProbe(const Vector& p) {
+        setType("PooledProbe");
+        setPosition(p);
+        setSolidness(Solidness::SPECTRAL);
+    }
+};
+
+// Larger than PooledProbe, so it takes the heap fallback.
+class PooledProbeChild : public PooledProbe {
+public:
+    char payload[64] = {};
+    PooledProbeChild() : PooledProbe(Vector(0, 0)) {}
+};
+
+static void test_PoolAllocator() {
+    df::LogManager::getInstance().writeLog("== Pool allocator test ==\n");
+    df::PoolAllocator& pool = PooledProbe::pool();
+    const int wave = 300;
+
+    std::vector<Object*> first;
+    for (int i = 0; i < wave; ++i) first.push_back(new PooledProbe(Vector(static_cast<float>(i % 70), 1)));
+    const int slabs = pool.getSlabCount();
+    TEST_ASSERT(pool.getLiveCount() == wave && pool.getCapacity() >= wave, "pooled Objects come from the type's slabs");
+
+    df::PoolAllocator::beginBatch();
+    delete first.back();
+    Object* during = new PooledProbe(Vector(0, 2));
+    df::PoolAllocator::endBatch();
+    TEST_ASSERT(during != first.back(), "blocks freed in a batch are not reused before it ends");
+    first.back() = during;
+
+    for (Object* o : first) o->markForDelete();
+    WM().update();
+    TEST_ASSERT(pool.getLiveCount() == 0 && WM().objectsOfType("PooledProbe").getCount() == 0,
+        "update() returns every pooled block");
+
+    std::vector<Object*> second;
+    for (int i = 0; i < wave; ++i) second.push_back(new PooledProbe(Vector(static_cast<float>(i % 70), 1)));
+    std::sort(first.begin(), first.end());
+    bool reused = true;
+    for (Object* o : second) reused = reused && std::binary_search(first.begin(), first.end(), o);
+    TEST_ASSERT(pool.getSlabCount() == slabs && reused, "steady-state respawn reuses freed blocks");
+    for (Object* o : second) o->markForDelete();
+
+    PooledProbeChild* child = new PooledProbeChild();
+    TEST_ASSERT(pool.getLiveCount() == wave, "larger subclass falls back to the heap");
+    child->markForDelete();
+    WM().update();
+    TEST_ASSERT(pool.getLiveCount() == 0, "pool empty after second wave");
+}
+
+// ---------- Object recycling tests ----------
+// Parked Objects drop out of update, draw, collisions and dispatch, and
+// come back with fresh ids and their interests intact.
+class RecycleProbe : public Object {
+public:
+    int steps = 0, draws = 0, hits = 0;
+    explicit RecycleProbe(const Vector& p) {
+        setType("RecycleProbe");
+        setPosition(p);
+        registerInterest(EventStep::TYPE_ID);
+    }
+    int onEvent(const Event& e) override {
+        if (e.is<EventStep>()) { ++steps; return 1; }
+        if (e.is<EventCollision>()) { ++hits; return 1; }
+        return 0;
+    }
+    int draw() override { ++draws; return 0; }
+};
+
+static void test_recycling() {
+    df::LogManager::getInstance().writeLog("== Object recycling test ==\n");
+    auto& GM = df::GameManager::getInstance();
+    RecycleProbe* a = new RecycleProbe(Vector(10, 10));
+    RecycleProbe* b = new RecycleProbe(Vector(12, 10));
+    const int type = a->getTypeId();
+    const int world = WM().getAllObjects().getCount();
+    const int old_id = a->getId();
+
+    a->deactivate();
+    TEST_ASSERT(a->isActive() && WM().getAllObjects().getCount() == world, "deactivate() waits for update()");
+    WM().update();
+    TEST_ASSERT(!a->isActive() && WM().getInactiveCount(type) == 1 && WM().getAllObjects().getCount() == world - 1
+        && WM().objectsOfType(type).getCount() == 1, "update() parks the Object out of the world");
+
+    const int sent = GM.onEvent(EventStep(0));
+    WM().draw();
+    CollisionProbe* mover = new CollisionProbe("RecycleMover", Vector(9, 10), Solidness::HARD);
+    mover->setVelocityX(1);
+    WM().update();
+    TEST_ASSERT(a->steps == 0 && a->draws == 0 && a->hits == 0 && mover->col_count == 0
+        && mover->getPosition().getX() == 10.f && sent >= 1 && b->steps == 1,
+        "parked Objects get no steps, draws or collisions");
+    mover->markForDelete();
+
+    a->setPosition(Vector(20, 5));
+    RecycleProbe* r = WM().reactivate<RecycleProbe>(type);
+    GM.onEvent(EventStep(1));
+    TEST_ASSERT(r == a && r->isActive() && r->getId() != old_id && r->steps == 1
+        && WM().getInactiveCount(type) == 0 && WM().objectsOfType(type).getCount() == 2,
+        "reactivate() reuses the parked Object with a fresh id and its interests");
+    TEST_ASSERT(WM().reactivate(type) == nullptr, "reactivate() with nothing parked returns nullptr");
+
+    b->deactivate();
+    WM().update();
+    b->markForDelete();
+    WM().update();
+    TEST_ASSERT(WM().getInactiveCount(type) == 0, "deleting a parked Object leaves the recycle list");
+    a->markForDelete();
+    WM().update();
+}
+
+// Parallel step handler that toggles its own velocity (started ones stop
+// again within the same step, so the set must follow the final value).
+class VelocityStepper : public Object {
+    bool m_stay;
+public:
+    static int moving_before; // Moving count when the batch started.
+    static std::atomic<bool> saw_change; // A handler saw the moving set change mid-batch.
+    VelocityStepper(const Vector& p, bool stay) : m_stay(stay) {
+        setType("VelocityStepper");
+        setPosition(p);
+        setSolidness(Solidness::SPECTRAL);
+        setParallelStep();
+        registerInterest(EventStep::TYPE_ID);
+    }
+    int onEvent(const Event& e) override {
+        if (!e.is<EventStep>()) return 0;
+        setVelocityX(1);
+        if (TransformStore::getInstance().getMovingCount() != moving_before) saw_change = true;
+        if (m_stay) setVelocityX(0);
+        return 1;
+    }
+};
+int VelocityStepper::moving_before = 0;
+std::atomic<bool> VelocityStepper::saw_change{ false };
+
+static void test_moving_set() {
+    df::LogManager::getInstance().writeLog("== Moving set test ==\n");
+    const TransformStore& ts = TransformStore::getInstance();
+    const int base = ts.getMovingCount();
+
+    std::vector<CollisionProbe*> walls;
+    for (int i = 0; i < 40; ++i)
+        walls.push_back(new CollisionProbe("RestProbe", Vector(static_cast<float>(i), 2), Solidness::HARD));
+    CollisionProbe* a = new CollisionProbe("MoveProbe", Vector(5, 20), Solidness::HARD);
+    CollisionProbe* b = new CollisionProbe("MoveProbe", Vector(5, 22), Solidness::HARD);
+    a->setVelocityX(1);
+    b->setVelocityY(-0.5f);
+    b->setVelocityX(1);
+    TEST_ASSERT(ts.getMovingCount() == base + 2, "only Objects with velocity join the moving set");
+
+    WM().update();
+    TEST_ASSERT(a->getPosition().getX() == 6.f && b->getPosition().getY() == 21.5f
+        && walls[0]->getPosition().getX() == 0.f, "update() moves the moving set");
+
+    a->setVelocityX(0);
+    WM().update();
+    TEST_ASSERT(ts.getMovingCount() == base + 1 && a->getPosition().getX() == 6.f && b->getPosition().getX() == 7.f,
+        "stopping leaves the moving set");
+
+    for (CollisionProbe* w : walls) w->markForDelete();
+    WM().update(); // removal swaps entries around the moving set
+    WM().update();
+    TEST_ASSERT(ts.getMovingCount() == base + 1 && b->getPosition().getX() == 9.f,
+        "moving set survives removal of resting Objects");
+
+    a->markForDelete();
+    b->markForDelete();
+    WM().update();
+    TEST_ASSERT(ts.getMovingCount() == base, "deleted movers leave the moving set");
+
+    // Parallel step handlers start and stop themselves; the moving set
+    // changes once the batch ends.
+    std::vector<VelocityStepper*> steppers;
+    for (int i = 0; i < 300; ++i)
+        steppers.push_back(new VelocityStepper(Vector(static_cast<float>(i % 70), static_cast<float>(i % 20)), i % 3 == 0));
+    VelocityStepper::moving_before = ts.getMovingCount();
+    df::GameManager::getInstance().onEvent(EventStep(0));
+    TEST_ASSERT(!VelocityStepper::saw_change && ts.getMovingCount() == base + 200,
+        "velocity set in parallel steps updates the moving set after the batch");
+    WM().update();
+    bool moved = true;
+    for (int i = 0; i < 300; ++i)
+        moved = moved && steppers[static_cast<std::size_t>(i)]->getPosition().getX() == static_cast<float>(i % 70 + (i % 3 == 0 ? 0 : 1));
+    TEST_ASSERT(moved, "only Objects started in parallel steps move");
+    for (VelocityStepper* s : steppers) s->markForDelete();
+    WM().update();
+}
+
+// Snapshot round trip: a per-type payload rides along with the transform.
+class SnapshotProbe : public Object {
+public:
+    static bool scratch_on_load; // loadPayload() spawns and deletes a helper Object.
+    int hp = 0;
+    SnapshotProbe() { setType("SnapshotProbe"); }
+    void savePayload(std::vector<char>& out) const override {
+        const char* p = reinterpret_cast<const char*>(&hp);
+        out.insert(out.end(), p, p + sizeof(hp));
+    }
+    int loadPayload(const char* data, std::size_t size) override {
+        if (size != sizeof(hp)) return -1;
+        std::memcpy(&hp, data, size);
+        if (scratch_on_load) delete new SnapshotProbe();
+        return 0;
+    }
+};
+bool SnapshotProbe::scratch_on_load = false;
+
+static void test_snapshot() {
+    df::LogManager::getInstance().writeLog("== World snapshot test ==\n");
+    auto objs = WM().getAllObjects();
+    for (int i = 0; i < objs.getCount(); ++i) if (objs[i]) objs[i]->markForDelete();
+    WM().update();
+    WM().registerSnapshotType<SnapshotProbe>("SnapshotProbe");
+    const char* path = "dragonfly.snapshot";
+
+    SnapshotProbe* a = new SnapshotProbe();
+    a->setPosition(Vector(5, 6)); a->setVelocity(1, 0);
+    a->setSolidness(Solidness::SOFT); a->setAltitude(3); a->hp = 7;
+    SnapshotProbe* b = new SnapshotProbe();
+    b->setPosition(Vector(20, 10)); b->hp = 9;
+    TEST_ASSERT(WM().saveSnapshot(path) == 2, "saveSnapshot() writes every Object in the world");
+    std::string saved;
+    if (std::FILE* f = std::fopen(path, "rb")) {
+        char buf[256];
+        for (std::size_t n; (n = std::fread(buf, 1, sizeof buf, f)) > 0;) saved.append(buf, n);
+        std::fclose(f);
+    }
+    a->markForDelete();
+    b->markForDelete();
+    WM().update();
+
+    const int moving = TransformStore::getInstance().getMovingCount();
+    TEST_ASSERT(WM().loadSnapshot(path) == 2 && WM().objectsOfType("SnapshotProbe").getCount() == 2,
+        "loadSnapshot() recreates the Objects");
+    SnapshotProbe* la = nullptr;
+    SnapshotProbe* lb = nullptr;
+    for (Object* o : WM().objectsOfType("SnapshotProbe")) {
+        SnapshotProbe* p = static_cast<SnapshotProbe*>(o);
+        (p->hp == 7 ? la : lb) = p;
+    }
+    TEST_ASSERT(la && lb && lb->hp == 9 && la->getPosition().getX() == 5.f && la->getPosition().getY() == 6.f
+        && la->getVelocityX() == 1.f && la->getSolidness() == Solidness::SOFT && la->getAltitude() == 3
+        && TransformStore::getInstance().getMovingCount() == moving + 1,
+        "loaded Objects keep transform, solidness, altitude and payload");
+
+    CollisionProbe* mover = new CollisionProbe("SnapshotMover", Vector(19, 10), Solidness::HARD);
+    mover->setVelocityX(1);
+    WM().update();
+    TEST_ASSERT(mover->col_count == 1 && la->getPosition().getX() == 6.f, "loaded Objects move and collide");
+    // Objects deleted during the load (here, a helper each loadPayload()
+    // spawns) are skipped when the load indexes what it inserted.
+    SnapshotProbe::scratch_on_load = true;
+    const int before_load = WM().getAllObjects().getCount();
+    const int loaded = WM().loadSnapshot(path);
+    SnapshotProbe::scratch_on_load = false;
+    TEST_ASSERT(loaded == 2 && WM().getAllObjects().getCount() == before_load + 2,
+        "Objects deleted during loadSnapshot() are not indexed");
+    for (Object* o : WM().objectsOfType("SnapshotProbe")) if (o != la && o != lb) o->markForDelete();
+    WM().update();
+    const int world = WM().getAllObjects().getCount();
+    TEST_ASSERT(WM().saveSnapshot(path) == world && WM().loadSnapshot(path) == -1
+        && WM().getAllObjects().getCount() == world, "a type without factory fails the load, creating nothing");
+    mover->markForDelete();
+    la->markForDelete();
+    lb->markForDelete();
+    WM().update();
+
+    if (std::FILE* f = std::fopen(path, "wb")) { std::fwrite("DFSN", 1, 4, f); std::fclose(f); }
+    TEST_ASSERT(WM().loadSnapshot(path) == -1 && WM().loadSnapshot("no-such.snapshot") == -1
+        && WM().getAllObjects().getCount() == 0, "truncated or missing snapshots fail");
+    // Cut inside the type name, then short of the record count.
+    const std::size_t records = 16 + 4 + std::strlen("SnapshotProbe");
+    bool cut_fail = saved.size() > records + 10;
+    for (std::size_t size : { records - 5, records + 10 }) {
+        if (std::FILE* f = std::fopen(path, "wb")) { std::fwrite(saved.data(), 1, size, f); std::fclose(f); }
+        cut_fail = cut_fail && WM().loadSnapshot(path) == -1;
+    }
+    TEST_ASSERT(cut_fail && WM().getAllObjects().getCount() == 0, "snapshots cut in a type name or the records fail");
+    // A header claiming ~4 billion types must fail, not try to reserve for them.
+    std::string huge = saved.substr(0, 16);
+    const std::uint32_t many = 0xFFFFFFFFu;
+    std::memcpy(&huge[8], &many, sizeof many);
+    if (std::FILE* f = std::fopen(path, "wb")) { std::fwrite(huge.data(), 1, huge.size(), f); std::fclose(f); }
+    TEST_ASSERT(WM().loadSnapshot(path) == -1, "a snapshot header with impossible counts fails");
+    std::remove(path);
+}
+
 static void test_GameManager_loop() {
     df::LogManager::getInstance().writeLog("== GameManager loop test ==\n");
     auto objs = WM().getAllObjects();
@@ -254,8 +971,133 @@ static void test_GameManager_loop() {
     WM().update();
 
     StepProbe p(5);
+    DummyObj* idle = new DummyObj(Vector(0.f, 0.f)); // never registers interest
     df::GameManager::getInstance().run(); // will stop after 5 steps via StepProbe
     TEST_ASSERT(p.getSeen() >= 5, "Game loop sent at least 5 EventStep events");
+    TEST_ASSERT(df::GameManager::getInstance().onEvent(EventStep(0)) == 1, "EventStep only sent to interested Objects");
+    TEST_ASSERT(p.unregisterInterest(EventStep::TYPE_ID) == 0 && df::GameManager::getInstance().onEvent(EventStep(0)) == 0,
+        "unregisterInterest() stops EventStep delivery");
+    idle->markForDelete(); WM().update();
+}
+
+// Headless simulation runs unpaced and stops on frame count or game over.
+static void test_GameManager_simulate() {
+    df::LogManager::getInstance().writeLog("== GameManager simulate test ==\n");
+    auto& GM = df::GameManager::getInstance();
+    {
+        StepProbe p(1000000);
+        df::Clock c;
+        const int steps = GM.simulate(300);
+        const long long us = c.split();
+        TEST_ASSERT(steps == 300 && p.getSeen() == 300, "simulate(300) runs exactly 300 steps");
+        TEST_ASSERT(us < 300LL * GM.getFrameTime() * 1000 / 4 && GM.getStepsPerSecond() > 0.0,
+            "simulate() is not held to the frame time");
+    }
+    {
+        StepProbe p(7);
+        TEST_ASSERT(GM.simulate(0) == 7, "simulate(0) runs until game over");
+    }
+    GM.setGameOver(false);
+}
+
+// ---------- LogManager tests ----------
+// Filtering happens before formatting; async mode takes writes from
+// worker threads and the writer drains them all in order per thread.
+static void test_LogManager() {
+    auto& LM = df::LogManager::getInstance();
+    LM.writeLog("== LogManager ==\n");
+
+    LM.setLevel(df::LOG_WARNING);
+    const int below = LM.writeLog(df::LOG_DEBUG, df::LOG_GAME, "filtered %d\n", 1);
+    const bool info_on = LM.isEnabled(df::LOG_INFO, df::LOG_GENERAL);
+    LM.setLevel(df::LOG_DEBUG);
+    TEST_ASSERT(below == 0 && !info_on, "messages below the level are filtered");
+    LM.setCategories(df::LOG_ALL & ~df::LOG_GAME);
+    const bool game_on = LM.isEnabled(df::LOG_ERROR, df::LOG_GAME);
+    const bool world_on = LM.isEnabled(df::LOG_ERROR, df::LOG_WORLD);
+    LM.setCategories(df::LOG_ALL);
+    TEST_ASSERT(!game_on && world_on, "disabled categories are filtered");
+
+    const bool was_async = LM.isAsync();
+    LM.setAsync(true);
+    const int lines = 2000;
+    df::JobManager::getInstance().parallelFor(lines, [&](int i) {
+        LM.writeLog(df::LOG_INFO, df::LOG_GAME, "[async %d]\n", i);
+    }, 16);
+    LM.setAsync(false); // drains the ring
+    const unsigned dropped = LM.getDroppedCount();
+
+    int found = 0;
+    if (std::FILE* f = std::fopen(df::LOGFILE_NAME.c_str(), "r")) {
+        char line[128];
+        while (std::fgets(line, sizeof line, f))
+            if (std::strncmp(line, "[async ", 7) == 0) ++found;
+        std::fclose(f);
+    }
+    TEST_ASSERT(found + static_cast<int>(dropped) == lines && found > 0,
+        "async log takes writes from worker threads");
+    LM.setAsync(was_async);
+}
+
+// ---------- TraceManager tests ----------
+static void test_TraceManager() {
+    df::LogManager::getInstance().writeLog("== TraceManager ==\n");
+    auto& TM = df::TraceManager::getInstance();
+    TEST_ASSERT(TM.isStarted() && TM.getSpanCount() > 0, "trace recorded spans from the game loop and jobs");
+
+    TM.shutDown();
+    const int before = TM.getSpanCount();
+    { df::TraceScope scope("not recorded"); }
+    TEST_ASSERT(TM.getSpanCount() == before, "TraceScope records nothing while stopped");
+
+    std::string json;
+    if (std::FILE* f = std::fopen(df::TRACEFILE_NAME.c_str(), "r")) {
+        char buf[4096];
+        for (std::size_t n; (n = std::fread(buf, 1, sizeof buf, f)) > 0; ) json.append(buf, n);
+        std::fclose(f);
+    }
+    TEST_ASSERT(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0
+        && json.find("\"name\":\"frame\"") != std::string::npos
+        && json.find("\"name\":\"STEP\",\"cat\":\"onEvent\"") != std::string::npos
+        && json.find("\"name\":\"job\"") != std::string::npos
+        && json.size() > 4 && json.compare(json.size() - 4, 4, "\n]}\n") == 0,
+        "shutDown() exports Chrome trace JSON");
+    TM.startUp();
+}
+
+// ---------- FrameProfiler tests ----------
+static void test_FrameProfiler() {
+    df::LogManager::getInstance().writeLog("== FrameProfiler ==\n");
+    df::FrameProfiler& fp = df::FrameProfiler::getInstance();
+    TEST_ASSERT(fp.getFrameCount() > 0, "game loop recorded profiled frames");
+    fp.dump();
+
+    fp.reset();
+    for (int i = 1; i <= 100; i++) {
+        fp.beginFrame();
+        fp.add(df::PHASE_STEP, i * 1000LL); // i microseconds
+        fp.endFrame();
+    }
+    const df::FrameProfiler::Stats s = fp.getStats(df::PHASE_STEP);
+    TEST_ASSERT(s.frames == 100 && s.min_us == 1.0 && s.avg_us == 50.5 && s.p99_us == 99.0,
+        "profiler min/avg/p99 over recorded frames");
+
+    for (int i = 0; i < df::PROFILER_FRAMES; i++) {
+        fp.beginFrame();
+        fp.add(df::PHASE_STEP, 7000);
+        fp.endFrame();
+    }
+    const df::FrameProfiler::Stats w = fp.getStats(df::PHASE_STEP);
+    TEST_ASSERT(w.frames == df::PROFILER_FRAMES && w.min_us == 7.0 && w.p99_us == 7.0,
+        "profiler ring keeps only the newest frames");
+
+    fp.reset();
+    fp.beginFrame();
+    { df::ProfileScope scope(df::PHASE_DRAW); sleep_ms(2); }
+    fp.endFrame();
+    TEST_ASSERT(fp.getStats(df::PHASE_DRAW).p99_us >= 1000.0 && fp.getStats(df::PHASE_FRAME).p99_us >= 1000.0,
+        "ProfileScope times its phase into the open frame");
+    fp.reset();
 }
 
 // ---------- Display/Input smoke tests ----------
@@ -263,21 +1105,78 @@ static void test_Display_smoke() {
     df::LogManager::getInstance().writeLog("== DisplayManager smoke ==\n");
     // Draw a tiny HUD for 2 frames just to ensure it runs
     auto& DM = DisplayManager::getInstance();
+    DM.setGridSize(0, 0); // Keep size, but force a full repaint.
     for (int i = 0; i < 2; ++i) {
         DM.drawString(Vector(1, 1), "Dragonfly text OK", Justify::LEFT);
         DM.swapBuffers();
+        if (i == 0)
+            TEST_ASSERT(DM.getChangedCellCount() == DM.getHorizontal() * DM.getVertical(), "first frame after resize repaints every cell");
         sleep_ms(33);
     }
-    TEST_ASSERT(true, "DisplayManager drew 2 frames");
+    TEST_ASSERT(DM.getChangedCellCount() == 0, "unchanged frame re-emits no cells");
+    DM.drawString(Vector(1, 1), "Dragonfly text ok", Justify::LEFT);
+    DM.swapBuffers();
+    TEST_ASSERT(DM.getChangedCellCount() == 2, "frame diff reports only the changed cells");
+    DM.swapBuffers();
+    TEST_ASSERT(DM.getChangedCellCount() == 15, "clearing the text re-emits its cells");
+}
+
+// Terminal backend writes only changed cells, with cursor moves and
+// color changes only where needed.
+static void test_Terminal_backend() {
+    df::LogManager::getInstance().writeLog("== Terminal backend ==\n");
+    std::FILE* f = std::tmpfile();
+    if (!f) { TEST_ASSERT(false, "tmpfile for terminal backend"); return; }
+    {
+        TerminalDisplayBackend term(fileno(f));
+        CellBuffer cells;
+        cells.resize(4, 2);
+        term.open(4, 2, 0, 0);
+
+        cells.put(0, 0, CellBuffer::pack('A', df::RED));
+        cells.put(1, 0, CellBuffer::pack('B', df::RED));
+        cells.put(0, 1, CellBuffer::pack('C', df::GREEN));
+        cells.present();
+        term.present(cells);
+
+        cells.put(0, 0, CellBuffer::pack('A', df::RED));
+        cells.put(1, 0, CellBuffer::pack('X', df::RED));
+        cells.put(0, 1, CellBuffer::pack('C', df::GREEN));
+        cells.present();
+        term.present(cells);
+
+        cells.put(0, 0, CellBuffer::pack('A', df::RED));
+        cells.put(1, 0, CellBuffer::pack('X', df::RED));
+        cells.put(0, 1, CellBuffer::pack('C', df::GREEN));
+        TEST_ASSERT(cells.present() == 0, "unchanged frame has no changed cells");
+        term.present(cells);
+    }
+
+    std::string out;
+    std::fseek(f, 0, SEEK_SET);
+    char buf[256];
+    for (std::size_t n; (n = std::fread(buf, 1, sizeof buf, f)) > 0; ) out.append(buf, n);
+    std::fclose(f);
+
+    const std::string expected =
+        "\x1b[?25l\x1b[2J"                                   // open
+        "\x1b[1;1H\x1b[31mAB  \x1b[2;1H\x1b[32mC   "          // full first frame
+        "\x1b[1;2H\x1b[31mX"                                 // one changed cell
+        "\x1b[0m\x1b[3;1H\x1b[?25h";                          // close
+    TEST_ASSERT(out == expected, "terminal backend emits minimal ANSI diff");
 }
 
 #if RUN_MANUAL_INPUT_TEST
 class InputCatcher : public Object {
 public:
     int kb_count = 0, mouse_count = 0;
+    InputCatcher() {
+        registerInterest(EventKeyboard::TYPE_ID);
+        registerInterest(EventMouse::TYPE_ID);
+    }
     int onEvent(const Event& e) override {
-        if (dynamic_cast<const EventKeyboard*>(&e)) { ++kb_count; return 1; }
-        if (dynamic_cast<const EventMouse*>(&e)) { ++mouse_count; return 1; }
+        if (e.is<EventKeyboard>()) { ++kb_count; return 1; }
+        if (e.is<EventMouse>()) { ++mouse_count; return 1; }
         return 0;
     }
 };
@@ -304,19 +1203,38 @@ int main() {
     auto& LM = df::LogManager::getInstance();
     if (LM.startUp() != 0) return 1;
     LM.setFlush(true); // easier to watch the log while running
+    LM.setAsync(true); // the writer thread flushes once per batch
 
     WM().startUp();
     auto& GM = df::GameManager::getInstance();
     GM.startUp();
     DisplayManager::getInstance().startUp();   // needed for draw()
     df::InputManager::getInstance().startUp();     // needed for input()
+    df::JobManager::getInstance().setThreadCount(3); // exercise stealing even on small machines
+    df::JobManager::getInstance().startUp();
+    df::TraceManager::getInstance().startUp();
 
     test_Vector();
     test_Clock();
+    test_FramePacer();
     test_Object_and_ObjectList();
     test_WorldManager_features();
     test_GameManager_loop();
+    test_GameManager_simulate();
+    test_parallel_step();
+    test_view_culling();
+    test_contacts();
+    test_AABBTree();
+    test_box_collisions();
+    test_PoolAllocator();
+    test_recycling();
+    test_moving_set();
+    test_snapshot();
+    test_LogManager();
+    test_TraceManager();
+    test_FrameProfiler();
     test_Display_smoke();
+    test_Terminal_backend();
 #if RUN_MANUAL_INPUT_TEST
     test_Input_manual();
 #endif
@@ -326,6 +1244,8 @@ int main() {
     // shutdown in reverse
 #if RUN_MANUAL_INPUT_TEST
 #endif
+    df::TraceManager::getInstance().shutDown();
+    df::JobManager::getInstance().shutDown();
     df::InputManager::getInstance().shutDown();
     DisplayManager::getInstance().shutDown();
     GM.shutDown();
@@ -1,12 +1,40 @@
 #pragma once
-#include <string>
 
 
+// Compile-time ids of engine events. Game-defined events pick ids at or
+// above USER_EVENT, e.g. static constexpr int TYPE_ID = USER_EVENT + 0;
+enum EventId : int {
+	UNDEFINED_EVENT = 0,
+	STEP_EVENT,
+	KEYBOARD_EVENT,
+	MOUSE_EVENT,
+	COLLISION_EVENT,
+	OUT_EVENT,
+	USER_EVENT = 16
+};
+
+
+// Base event. Dispatch uses the integer id; the name is for logging only.
+// Each subclass defines TYPE_ID and TYPE and passes them to this ctor.
 class Event {
-	std::string m_type;
+	int m_type_id;
+	const char* m_type_name;
 public:
-	explicit Event(std::string type = "") : m_type(std::move(type)) {}
+	static constexpr int TYPE_ID = UNDEFINED_EVENT;
+	static constexpr const char* TYPE = "undefined";
+
+	explicit Event(int type_id = TYPE_ID, const char* type_name = TYPE)
+		: m_type_id(type_id), m_type_name(type_name) {}
 	virtual ~Event() = default;
-	const std::string& getType() const { return m_type; }
-	void setType(const std::string& t) { m_type = t; }
-};
\ No newline at end of file
+
+	int getTypeId() const { return m_type_id; }
+	const char* getTypeName() const { return m_type_name; }
+
+	// True if this event is a T (integer compare, no RTTI).
+	template <class T> bool is() const { return m_type_id == T::TYPE_ID; }
+
+	// This event as a T, or nullptr if it is not one.
+	template <class T> const T* as() const {
+		return is<T>() ? static_cast<const T*>(this) : nullptr;
+	}
+};
@@ -1,2 +0,0 @@
-#include "EventCollision.h"
-const std::string EventCollision::TYPE = "collision";
\ No newline at end of file
@@ -1,22 +1,31 @@
 #pragma once
 #include "Event.h"
 #include "Vector.h"
-#include <string>
 
 class Object;
 
+// Where a collision is in the life of a contact between two objects.
+enum class CollisionPhase {
+    BEGIN, // First step the two touch.
+    STAY,  // Still touching (only sent if WorldManager::setContactStay()).
+    END    // No longer touching.
+};
+
 // Carries collision info between two objects at a world position.
 class EventCollision : public Event {
     Object* m_p_obj1{ nullptr };
     Object* m_p_obj2{ nullptr };
     Vector  m_pos; // collision position in world coords
+    CollisionPhase m_phase{ CollisionPhase::BEGIN };
 
 public:
-    static const std::string TYPE; // "collision"
+    static constexpr int TYPE_ID = COLLISION_EVENT;
+    static constexpr const char* TYPE = "collision";
 
-    EventCollision() : Event(TYPE) {}
-    EventCollision(Object* a, Object* b, const Vector& where)
-        : Event(TYPE), m_p_obj1(a), m_p_obj2(b), m_pos(where) {
+    EventCollision() : Event(TYPE_ID, TYPE) {}
+    EventCollision(Object* a, Object* b, const Vector& where,
+        CollisionPhase phase = CollisionPhase::BEGIN)
+        : Event(TYPE_ID, TYPE), m_p_obj1(a), m_p_obj2(b), m_pos(where), m_phase(phase) {
     }
 
     // Get/set colliders
@@ -28,4 +37,8 @@ public:
     // Get/set collision position
     void    setPosition(const Vector& v) { m_pos = v; }
     Vector  getPosition() const { return m_pos; }
+
+    // Get/set contact phase
+    void    setPhase(CollisionPhase phase) { m_phase = phase; }
+    CollisionPhase getPhase() const { return m_phase; }
 };
\ No newline at end of file
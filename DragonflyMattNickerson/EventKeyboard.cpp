@@ -1,2 +0,0 @@
-#include "EventKeyboard.h"
-const std::string EventKeyboard::TYPE = "keyboard";
\ No newline at end of file
@@ -1,2 +0,0 @@
-#include "EventMouse.h"
-const std::string EventMouse::TYPE = "mouse";
@@ -1,6 +1,5 @@
 #pragma once
 #include "Event.h"
-#include <string>
 
 // High-level mouse actions and buttons
 enum class MouseAction { Moved, Pressed, Released };
@@ -14,11 +13,12 @@ class EventMouse : public Event {
     int         m_y{ 0 };// screen Y
 
 public:
-    static const std::string TYPE; // "mouse"
+    static constexpr int TYPE_ID = MOUSE_EVENT;
+    static constexpr const char* TYPE = "mouse";
 
-    EventMouse() : Event(TYPE) {}
+    EventMouse() : Event(TYPE_ID, TYPE) {}
     EventMouse(MouseAction act, MouseButton btn, int x, int y)
-        : Event(TYPE), m_action(act), m_button(btn), m_x(x), m_y(y) {
+        : Event(TYPE_ID, TYPE), m_action(act), m_button(btn), m_x(x), m_y(y) {
     }
 
     // Action
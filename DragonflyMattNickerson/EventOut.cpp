@@ -1,4 +0,0 @@
-#include "EventOut.h"
-
-
-const std::string EventOut::TYPE = "out";
\ No newline at end of file
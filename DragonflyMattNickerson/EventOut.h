@@ -1,9 +1,10 @@
 #pragma once
 #include "Event.h"
-#include <string>
 
 class EventOut : public Event {
 public:
-	static const std::string TYPE;
-	EventOut() : Event(TYPE) {}
+	static constexpr int TYPE_ID = OUT_EVENT;
+	static constexpr const char* TYPE = "out";
+
+	EventOut() : Event(TYPE_ID, TYPE) {}
 };
\ No newline at end of file
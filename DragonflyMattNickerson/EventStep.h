@@ -5,7 +5,10 @@
 class EventStep : public Event {
 	int m_step = 0;
 public:
-	explicit EventStep(int step = 0) : Event("STEP"), m_step(step) {}
+	static constexpr int TYPE_ID = STEP_EVENT;
+	static constexpr const char* TYPE = "STEP";
+
+	explicit EventStep(int step = 0) : Event(TYPE_ID, TYPE), m_step(step) {}
 	int getStepCount() const { return m_step; }
 	void setStepCount(int s) { m_step = s; }
 };
\ No newline at end of file
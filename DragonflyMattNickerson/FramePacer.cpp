@@ -0,0 +1,111 @@
+#include "FramePacer.h"
+
+#include <cmath>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <time.h>
+#endif
+
+
+namespace df {
+
+	namespace {
+#if defined(_WIN32)
+		// Windows sleeps are only accurate to the scheduler tick.
+		const long long SPIN_DEFAULT_US = 2000;
+#else
+		const long long SPIN_DEFAULT_US = 200;
+#endif
+
+		// Sleep until an absolute point on the steady clock.
+		void sleepUntil(FramePacer::clock::time_point when) {
+#if defined(__linux__)
+			// steady_clock is CLOCK_MONOTONIC on Linux, so its epoch offset
+			// is a CLOCK_MONOTONIC absolute time.
+			const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				when.time_since_epoch()).count();
+			timespec ts;
+			ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+			ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+			while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#else
+			std::this_thread::sleep_until(when);
+#endif
+		}
+	}
+
+	FramePacer::FramePacer(long long period_us, long long spin_us)
+		: m_period(std::chrono::microseconds(period_us)),
+		m_spin(std::chrono::microseconds(spin_us < 0 ? SPIN_DEFAULT_US : spin_us)),
+		m_started(false) {
+		resetStats();
+	}
+
+	void FramePacer::setPeriod(long long period_us) {
+		m_period = std::chrono::microseconds(period_us);
+	}
+
+	long long FramePacer::getPeriod() const {
+		return std::chrono::duration_cast<std::chrono::microseconds>(m_period).count();
+	}
+
+	void FramePacer::setSpin(long long spin_us) {
+		m_spin = std::chrono::microseconds(spin_us < 0 ? SPIN_DEFAULT_US : spin_us);
+	}
+
+	void FramePacer::start() {
+		m_deadline = clock::now() + m_period;
+		m_started = true;
+	}
+
+	long long FramePacer::wait() {
+		if (!m_started) start();
+
+		clock::time_point now = clock::now();
+		if (now >= m_deadline) {
+			// Overran. Resync if more than a whole period behind, so a long
+			// stall doesn't cause a burst of unpaced frames.
+			++m_overruns;
+			m_deadline += m_period;
+			if (now > m_deadline) m_deadline = now + m_period;
+			return 0;
+		}
+
+		if (m_deadline - now > m_spin) sleepUntil(m_deadline - m_spin);
+		while ((now = clock::now()) < m_deadline) {}
+
+		const long long late_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_deadline).count();
+		addSample(late_ns / 1000.0);
+		m_deadline += m_period;
+		return late_ns / 1000;
+	}
+
+	void FramePacer::addSample(double late_us) {
+		++m_frames;
+		const double d = late_us - m_mean;
+		m_mean += d / static_cast<double>(m_frames);
+		m_m2 += d * (late_us - m_mean);
+		if (late_us > m_max) m_max = late_us;
+	}
+
+	FramePacer::Stats FramePacer::getStats() const {
+		Stats s;
+		s.frames = m_frames;
+		s.overruns = m_overruns;
+		s.mean_late_us = m_mean;
+		s.jitter_us = m_frames > 1 ? std::sqrt(m_m2 / static_cast<double>(m_frames - 1)) : 0.0;
+		s.max_late_us = m_max;
+		return s;
+	}
+
+	void FramePacer::resetStats() {
+		m_frames = 0;
+		m_overruns = 0;
+		m_mean = 0.0;
+		m_m2 = 0.0;
+		m_max = 0.0;
+	}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+
+
+namespace df {
+
+
+	// Paces a loop to a fixed period against absolute deadlines on the
+	// monotonic clock. Each wait() sleeps until shortly before the deadline,
+	// then spins the rest of the way. Deadlines advance by exactly one
+	// period, so lateness in one frame never shifts the schedule (no drift).
+	// If the loop falls more than a period behind, the schedule restarts
+	// from now rather than rushing to catch up.
+	class FramePacer {
+	public:
+		using clock = std::chrono::steady_clock;
+
+		// Lateness of each wake-up past its deadline, in microseconds.
+		struct Stats {
+			long long frames;    // wait() calls that slept.
+			long long overruns;  // Frames that ran past their deadline.
+			double mean_late_us;
+			double jitter_us;    // Standard deviation of lateness.
+			double max_late_us;
+		};
+
+	private:
+		clock::duration m_period;
+		clock::duration m_spin;      // Spin this long before each deadline.
+		clock::time_point m_deadline;
+		bool m_started;
+
+		// Running lateness stats (Welford).
+		long long m_frames;
+		long long m_overruns;
+		double m_mean;
+		double m_m2;
+		double m_max;
+
+		void addSample(double late_us);
+
+	public:
+		// Period and spin margin in microseconds.
+		explicit FramePacer(long long period_us = 33000, long long spin_us = -1);
+
+
+		// Set period in microseconds (takes effect from the next deadline).
+		void setPeriod(long long period_us);
+		long long getPeriod() const;
+
+
+		// Set the spin margin in microseconds (-1 = platform default).
+		void setSpin(long long spin_us);
+
+
+		// Start the schedule: first deadline is one period from now.
+		void start();
+
+
+		// Block until the current deadline, then advance it one period.
+		// Return microseconds the wake-up was late (0 if the frame had
+		// already overrun its deadline).
+		long long wait();
+
+
+		// Lateness stats since the last reset.
+		Stats getStats() const;
+		void resetStats();
+	};
+
+
+}
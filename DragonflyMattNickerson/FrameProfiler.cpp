@@ -0,0 +1,90 @@
+#include "FrameProfiler.h"
+#include "LogManager.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace df {
+
+
+	FrameProfiler::FrameProfiler() : m_current(0), m_frames(0) {
+		std::memset(m_ns, 0, sizeof(m_ns));
+	}
+
+	FrameProfiler& FrameProfiler::getInstance() {
+		static FrameProfiler inst;
+		return inst;
+	}
+
+	void FrameProfiler::beginFrame() {
+		std::memset(m_ns[m_current], 0, sizeof(m_ns[m_current]));
+		m_frame_start = std::chrono::steady_clock::now();
+	}
+
+	void FrameProfiler::endFrame() {
+		const auto elapsed = std::chrono::steady_clock::now() - m_frame_start;
+		m_ns[m_current][PHASE_FRAME] = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+		m_current = (m_current + 1) % PROFILER_FRAMES;
+		if (m_frames < PROFILER_FRAMES) ++m_frames;
+	}
+
+	// The open frame is excluded: completed frames sit just behind m_current.
+	FrameProfiler::Stats FrameProfiler::getStats(ProfilePhase phase) const {
+		Stats s{ 0.0, 0.0, 0.0, m_frames };
+		if (m_frames == 0) return s;
+
+		long long samples[PROFILER_FRAMES];
+		long long sum = 0;
+		for (int i = 0; i < m_frames; i++) {
+			const int slot = (m_current - 1 - i + PROFILER_FRAMES) % PROFILER_FRAMES;
+			samples[i] = m_ns[slot][phase];
+			sum += samples[i];
+		}
+
+		// Nearest-rank 99th percentile.
+		const int rank = (m_frames * 99 + 99) / 100 - 1;
+		std::nth_element(samples, samples + rank, samples + m_frames);
+		s.p99_us = samples[rank] / 1000.0;
+		s.min_us = *std::min_element(samples, samples + m_frames) / 1000.0;
+		s.avg_us = static_cast<double>(sum) / m_frames / 1000.0;
+		return s;
+	}
+
+	void FrameProfiler::reset() {
+		m_current = 0;
+		m_frames = 0;
+		std::memset(m_ns, 0, sizeof(m_ns));
+	}
+
+	void FrameProfiler::dump() const {
+		LogManager& log = LogManager::getInstance();
+		log.writeLog("Frame profile (%d frames, microseconds)\n", m_frames);
+		log.writeLog("  %-10s %10s %10s %10s\n", "phase", "min", "avg", "p99");
+		for (int p = 0; p < PHASE_COUNT; p++) {
+			const ProfilePhase phase = static_cast<ProfilePhase>(p);
+			const bool sub = phase == PHASE_MOVE || phase == PHASE_COLLIDE || phase == PHASE_DELETE;
+			const Stats s = getStats(phase);
+			log.writeLog("  %s%-*s %10.1f %10.1f %10.1f\n", sub ? "  " : "", sub ? 8 : 10,
+				getPhaseName(phase), s.min_us, s.avg_us, s.p99_us);
+		}
+	}
+
+	const char* FrameProfiler::getPhaseName(ProfilePhase phase) {
+		switch (phase) {
+		case PHASE_INPUT:   return "input";
+		case PHASE_STEP:    return "step";
+		case PHASE_UPDATE:  return "update";
+		case PHASE_MOVE:    return "move";
+		case PHASE_COLLIDE: return "collide";
+		case PHASE_DELETE:  return "delete";
+		case PHASE_DRAW:    return "draw";
+		case PHASE_SWAP:    return "swap";
+		case PHASE_SLEEP:   return "sleep";
+		case PHASE_FRAME:   return "frame";
+		default:            return "unknown";
+		}
+	}
+
+
+}
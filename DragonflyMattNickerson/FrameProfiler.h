@@ -0,0 +1,110 @@
+#pragma once
+#include <chrono>
+
+
+namespace df {
+
+
+	// Phases of one game loop iteration. MOVE, COLLIDE and DELETE are
+	// sub-phases of UPDATE; FRAME is the whole iteration including SLEEP.
+	enum ProfilePhase {
+		PHASE_INPUT = 0,
+		PHASE_STEP,
+		PHASE_UPDATE,
+		PHASE_MOVE,     // Vectorized integration of all movers.
+		PHASE_COLLIDE,  // Per-mover bounds, collision and out-of-world checks.
+		PHASE_DELETE,   // Deferred deletion.
+		PHASE_DRAW,
+		PHASE_SWAP,
+		PHASE_SLEEP,
+		PHASE_FRAME,
+		PHASE_COUNT
+	};
+
+
+	// Frames of history kept per phase.
+	const int PROFILER_FRAMES = 256;
+
+
+	// Per-phase frame timings kept in a fixed-size ring buffer. GameManager
+	// opens and closes a frame around each loop iteration; ProfileScope
+	// timers add into the open frame. No allocation after construction.
+	class FrameProfiler {
+	private:
+		FrameProfiler();
+		FrameProfiler(const FrameProfiler&) = delete;
+		FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+		long long m_ns[PROFILER_FRAMES][PHASE_COUNT]; // Nanoseconds per frame and phase.
+		int m_current;  // Ring slot of the open frame.
+		int m_frames;   // Completed frames held (at most PROFILER_FRAMES).
+		std::chrono::steady_clock::time_point m_frame_start; // When the open frame began.
+
+	public:
+		// Min/avg/p99 of one phase over the held frames, in microseconds.
+		struct Stats {
+			double min_us;
+			double avg_us;
+			double p99_us;
+			int frames;
+		};
+
+		// Get the one and only instance of the FrameProfiler.
+		static FrameProfiler& getInstance();
+
+
+		// Start a new frame (clears its ring slot).
+		void beginFrame();
+
+
+		// Close the frame, recording its total time as PHASE_FRAME, so it
+		// counts toward stats.
+		void endFrame();
+
+
+		// Add time to a phase of the open frame.
+		void add(ProfilePhase phase, long long ns) { m_ns[m_current][phase] += ns; }
+
+
+		// Stats for a phase over the held frames (all zero if none).
+		Stats getStats(ProfilePhase phase) const;
+
+
+		// Number of completed frames held.
+		int getFrameCount() const { return m_frames; }
+
+
+		// Drop all history.
+		void reset();
+
+
+		// Write a min/avg/p99 table of every phase to the logfile.
+		void dump() const;
+
+
+		// Return printable name of phase.
+		static const char* getPhaseName(ProfilePhase phase);
+	};
+
+
+	// Times its own lifetime into a phase of the open frame.
+	class ProfileScope {
+	private:
+		ProfilePhase m_phase;
+		std::chrono::steady_clock::time_point m_start;
+
+	public:
+		explicit ProfileScope(ProfilePhase phase)
+			: m_phase(phase), m_start(std::chrono::steady_clock::now()) {}
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+		~ProfileScope() {
+			const auto elapsed = std::chrono::steady_clock::now() - m_start;
+			FrameProfiler::getInstance().add(m_phase,
+				std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		}
+	};
+
+
+}
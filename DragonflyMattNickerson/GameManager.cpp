@@ -3,25 +3,20 @@
 #include "LogManager.h"
 #include "WorldManager.h"
 #include "EventStep.h"
-#include "Clock.h"
 #include "DisplayManager.h"
 #include "InputManager.h"
-#include <Windows.h>
+#include "JobManager.h"
+#include "FrameProfiler.h"
+#include "TraceManager.h"
+#include <chrono>
 
 namespace df {
 
-namespace {
-// Sleep helper in microseconds (round up to ms for Sleep()).
-inline void sleepMicros(long long usec) {
-  if (usec <= 0) return;
-  DWORD ms = static_cast<DWORD>((usec + 999) / 1000);
-  ::Sleep(ms);
-}
-}
-
 GameManager::GameManager()
   : game_over(true),
-    frame_time(FRAME_TIME_DEFAULT) {
+    frame_time(FRAME_TIME_DEFAULT),
+    m_pacer(FRAME_TIME_DEFAULT * 1000LL),
+    m_steps_per_second(0.0) {
   setType("GameManager");
 }
 
@@ -33,17 +28,15 @@ GameManager& GameManager::getInstance() {
 int GameManager::startUp() {
   if (isStarted()) return 0;
 
-  // Improve Sleep() resolution for this process
-
   game_over = false;
 
   Manager::startUp();
-  LogManager::getInstance().writeLog("GameManager started\n");
+  LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "GameManager started\n");
   return 0;
 }
 
 void GameManager::shutDown() {
-  LogManager::getInstance().writeLog("GameManager shutting down\n");
+  LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "GameManager shutting down\n");
   game_over = true;
 
 
@@ -54,50 +47,111 @@ void GameManager::setGameOver(bool new_game_over) { game_over = new_game_over; }
 bool GameManager::getGameOver() const { return game_over; }
 int  GameManager::getFrameTime() const { return frame_time; }
 
+// Send step to interested Objects. Serial handlers run first, in
+// registration order; parallel ones then run as one batch whose deferred
+// side effects are applied in registration order.
+int GameManager::onEvent(const Event& e) {
+  if (!e.is<EventStep>()) return Manager::onEvent(e);
+  TraceScope trace(e.getTypeName(), "onEvent");
+
+  m_parallel_step.clear();
+  int count = 0;
+  for (Object* o : getInterested(EventStep::TYPE_ID)) {
+    if (!o) continue;
+    ++count;
+    if (o->isParallelStep()) m_parallel_step.push_back(o);
+    else o->onEvent(e);
+  }
+
+  JobManager::getInstance().parallelFor(static_cast<int>(m_parallel_step.size()),
+    [&](int i) { m_parallel_step[static_cast<std::size_t>(i)]->onEvent(e); });
+  return count;
+}
+
+// GameManager only handles step events.
+bool GameManager::isValid(int event_type) const {
+  return event_type == EventStep::TYPE_ID;
+}
+
+// One iteration of the game loop, minus pacing.
+void GameManager::runFrame(int step_count, bool with_input, bool with_render) {
+    if (with_input) {
+        ProfileScope scope(PHASE_INPUT);
+        InputManager::getInstance().getInput();
+    }
+    {
+        ProfileScope scope(PHASE_STEP);
+        EventStep evt(step_count);
+        onEvent(evt); // only Objects that registered interest in steps
+    }
+    WorldManager::getInstance().update(); // deferred deletes, moves, etc.
+    if (with_render) {
+        {
+            ProfileScope scope(PHASE_DRAW);
+            WorldManager::getInstance().draw();
+        }
+        ProfileScope scope(PHASE_SWAP);
+        DisplayManager::getInstance().swapBuffers();
+    }
+}
+
 void GameManager::run() {
     if (!isStarted()) return;
 
-    LogManager::getInstance().writeLog("Game loop starting\n");
+    LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "Game loop starting\n");
 
-    Clock clock;  // microsecond timer
-    long long adjust_us = 0; // oversleep adjustment
-    const long long target_us = static_cast<long long>(frame_time) * 1000LL;
+    // Frames start on a fixed schedule; a slow frame doesn't push later ones back.
+    m_pacer.setPeriod(static_cast<long long>(frame_time) * 1000LL);
+    m_pacer.resetStats();
+    m_pacer.start();
 
+    FrameProfiler& profiler = FrameProfiler::getInstance();
     int step_count = 0;
     while (!game_over) {
-        clock.delta();   // begin timing this iteration
-
-        InputManager::getInstance().getInput();
-        
-         EventStep evt(step_count);
-         auto objs = WorldManager::getInstance().getAllObjects();  
-         for (int i = 0; i < objs.getCount(); ++i) {
-             Object* o = const_cast<Object*>(objs[i]);              
-             if (o) o->onEvent(evt);
-         }
-         WorldManager::getInstance().update(); // deferred deletes, moves, etc.
-         WorldManager::getInstance().draw();
-         DisplayManager::getInstance().swapBuffers();
-
-        long long loop_time = clock.split();
-        long long intended_sleep = target_us - loop_time - adjust_us;
-
-        if (intended_sleep > 0) {
-            clock.delta();
-            sleepMicros(intended_sleep);
-            long long actual_sleep = clock.split();
-            adjust_us = actual_sleep - intended_sleep;   // carry oversleep to next frame
-            if (adjust_us < 0) adjust_us = 0;
-        }
-        else {
-            adjust_us = 0;                                
+        TraceScope frame_scope("frame", "frame");
+        profiler.beginFrame();
+        runFrame(step_count, true, true);
+        {
+            ProfileScope scope(PHASE_SLEEP);
+            m_pacer.wait();
         }
+        profiler.endFrame();
 
         ++step_count;
     }
 
-    LogManager::getInstance().writeLog("Game loop ended\n");
+    LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "Game loop ended\n");
+    const FramePacer::Stats pace = m_pacer.getStats();
+    LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE,
+        "Frame pacing: %lld frames, %lld overruns, late mean %.1f us, jitter %.1f us, max %.1f us\n",
+        pace.frames, pace.overruns, pace.mean_late_us, pace.jitter_us, pace.max_late_us);
+    profiler.dump();
 }
 
+// Step as fast as possible: no pacing, input and rendering only if asked.
+// Stops after frames steps (if > 0) or at game over. Return steps run.
+int GameManager::simulate(int frames, bool with_input, bool with_render) {
+    if (!isStarted()) return 0;
 
-} 
+    LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "Simulation starting\n");
+    game_over = false;
+    const auto start = std::chrono::steady_clock::now();
+    FrameProfiler& profiler = FrameProfiler::getInstance();
+    int step_count = 0;
+    while (!game_over && (frames <= 0 || step_count < frames)) {
+        TraceScope frame_scope("frame", "frame");
+        profiler.beginFrame();
+        runFrame(step_count, with_input, with_render);
+        profiler.endFrame();
+        ++step_count;
+    }
+
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_steps_per_second = secs > 0.0 ? step_count / secs : 0.0;
+    LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE,
+        "Simulation ended: %d steps in %.3f s (%.0f steps/sec)\n", step_count, secs, m_steps_per_second);
+    return step_count;
+}
+
+
+}
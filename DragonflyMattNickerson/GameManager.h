@@ -1,5 +1,9 @@
 #pragma once
 #include "Manager.h"
+#include "FramePacer.h"
+#include <vector>
+
+class Object;
 
 namespace df {
 
@@ -14,6 +18,12 @@ namespace df {
 
 		bool game_over; 
 		int  frame_time;
+		std::vector<Object*> m_parallel_step; // Step handlers run on the JobManager (reused).
+		FramePacer m_pacer; // Holds the loop to frame_time.
+		double m_steps_per_second; // Rate of the last simulate() call.
+
+		// One iteration of the loop (input, step, update, draw, swap), no pacing.
+		void runFrame(int step_count, bool with_input, bool with_render);
 
 	public:
 		static GameManager& getInstance();
@@ -22,9 +32,30 @@ namespace df {
 		void shutDown();
 		void run();
 
+		// Headless batch mode: step as fast as possible, with no frame
+		// pacing, for frames steps (or until game over if frames <= 0).
+		// Input and rendering are skipped unless asked for. Clears game
+		// over first, so batch runs can be repeated.
+		// Return number of steps run; see getStepsPerSecond().
+		int simulate(int frames, bool with_input = false, bool with_render = false);
+
+		// Steps per second achieved by the last simulate() call.
+		double getStepsPerSecond() const { return m_steps_per_second; }
+
+		// Send step to interested Objects: handlers that opted in with
+		// Object::setParallelStep() run on the JobManager, the rest serially.
+		// Return count of Objects sent to.
+		int onEvent(const Event& e) override;
+
+		// GameManager only handles step events.
+		bool isValid(int event_type) const override;
+
 		void setGameOver(bool new_game_over = true);
 		bool getGameOver() const;
 		int  getFrameTime() const;
+
+		// Frame pacing stats (lateness and jitter of each frame's wake-up).
+		const FramePacer& getPacer() const { return m_pacer; }
 	};
 
 }
@@ -5,10 +5,15 @@
 #include "EventKeyboard.h"
 #include "EventMouse.h"
 
+#if defined(_WIN32)
 #include <Windows.h>
+#endif
 
 using df::InputManager;
 
+// Devices are polled through the Win32 API. Other platforms build
+// without input: getInput() generates no events there.
+#if defined(_WIN32)
 namespace {
 
     static const int kTrackedVKs[] = {
@@ -23,14 +28,12 @@ namespace {
         return (GetAsyncKeyState(vk) & 0x8000) != 0;
     }
 
-    inline void dispatchToAll(const Event& e) {
-        auto list = WM().getAllObjects();
-        for (int i = 0; i < list.getCount(); ++i) {
-            if (auto* o = list[i]) o->onEvent(e);
-        }
+    inline void dispatch(const Event& e) {
+        InputManager::getInstance().onEvent(e);
     }
 
 } 
+#endif
 
 namespace df {
 
@@ -50,26 +53,33 @@ namespace df {
         for (bool& b : m_prev_keys) b = false;
         m_prev_lb = m_prev_rb = m_prev_mb = false;
 
+        m_prev_x = m_prev_y = 0;
+#if defined(_WIN32)
         POINT p{};
         if (GetCursorPos(&p)) {
             m_prev_x = p.x;
             m_prev_y = p.y;
         }
-        else {
-            m_prev_x = m_prev_y = 0;
-        }
+#endif
 
         Manager::startUp();
-        LogManager::getInstance().writeLog("InputManager started\n");
+        LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "InputManager started\n");
         return 0;
     }
 
     void InputManager::shutDown() {
-        LogManager::getInstance().writeLog("InputManager shutting down\n");
+        LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "InputManager shutting down\n");
         Manager::shutDown();
     }
+
+    // InputManager only handles keyboard and mouse events.
+    bool InputManager::isValid(int event_type) const {
+        return event_type == EventKeyboard::TYPE_ID || event_type == EventMouse::TYPE_ID;
+    }
+
 	// Get input from keyboard and mouse, generate events as needed.
     void InputManager::getInput() const {
+#if defined(_WIN32)
         for (int vk : kTrackedVKs) {
             bool down = keyDown(vk);
             bool was = m_prev_keys[vk];
@@ -77,11 +87,11 @@ namespace df {
             if (down && !was) {
                 // Key pressed
                 EventKeyboard ek(vk);
-                dispatchToAll(ek);
+                dispatch(ek);
             }
             else if (!down && was) {
                 EventKeyboard ek(-vk);
-                dispatchToAll(ek);
+                dispatch(ek);
             }
             m_prev_keys[vk] = down;
         }
@@ -94,19 +104,19 @@ namespace df {
         if (lb != m_prev_lb) {
             EventMouse em(lb ? MouseAction::Pressed : MouseAction::Released,
                 MouseButton::Left, m_prev_x, m_prev_y);
-            dispatchToAll(em);
+            dispatch(em);
             m_prev_lb = lb;
         }
         if (rb != m_prev_rb) {
             EventMouse em(rb ? MouseAction::Pressed : MouseAction::Released,
                 MouseButton::Right, m_prev_x, m_prev_y);
-            dispatchToAll(em);
+            dispatch(em);
             m_prev_rb = rb;
         }
         if (mb != m_prev_mb) {
             EventMouse em(mb ? MouseAction::Pressed : MouseAction::Released,
                 MouseButton::Middle, m_prev_x, m_prev_y);
-            dispatchToAll(em);
+            dispatch(em);
             m_prev_mb = mb;
         }
 
@@ -114,11 +124,12 @@ namespace df {
         if (GetCursorPos(&p)) {
             if (p.x != m_prev_x || p.y != m_prev_y) {
                 EventMouse move(MouseAction::Moved, MouseButton::None, static_cast<int>(p.x), static_cast<int>(p.y));
-                dispatchToAll(move);
+                dispatch(move);
                 m_prev_x = p.x;
                 m_prev_y = p.y;
             }
         }
+#endif
     }
 
 } 
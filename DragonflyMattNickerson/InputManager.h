@@ -27,7 +27,11 @@ namespace df {
 		// Revert back to normal window mode.
 		void shutDown() override;
 
-		// Get input from the keyboard and mouse. Pass events to all Objects.
+		// InputManager only handles keyboard and mouse events.
+		bool isValid(int event_type) const override;
+
+
+		// Get input from the keyboard and mouse. Pass events to interested Objects.
 		void getInput() const;
 	};
 
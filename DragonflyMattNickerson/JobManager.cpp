@@ -0,0 +1,199 @@
+#include "JobManager.h"
+#include "LogManager.h"
+#include "TraceManager.h"
+#include <algorithm>
+
+namespace df {
+
+namespace {
+	// Per-thread job context: worker index (-1 outside jobs), item being
+	// run and count of work deferred by that item so far.
+	thread_local int t_worker = -1;
+	thread_local int t_item = 0;
+	thread_local int t_seq = 0;
+}
+
+JobManager::JobManager()
+	: m_requested_threads(-1), m_generation(0), m_quit(false), m_chunks_left(0) {
+	setType("JobManager");
+	m_workers.push_back(std::make_unique<Worker>()); // caller's slot, valid before startUp()
+}
+
+// Join helper threads if shutDown() was never called.
+JobManager::~JobManager() {
+	{
+		std::lock_guard<std::mutex> g(m_wake_lock);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+	for (std::size_t i = 1; i < m_workers.size(); ++i) {
+		if (m_workers[i]->thread.joinable()) m_workers[i]->thread.join();
+	}
+}
+
+// Get the one and only instance of the JobManager.
+JobManager& JobManager::getInstance() {
+	static JobManager inst;
+	return inst;
+}
+
+// Start helper threads. Return 0 if ok, else -1.
+int JobManager::startUp() {
+	if (isStarted()) return 0;
+
+	int helpers = m_requested_threads;
+	if (helpers < 0) {
+		const unsigned hw = std::thread::hardware_concurrency();
+		helpers = (hw > 1) ? static_cast<int>(hw) - 1 : 0;
+	}
+
+	m_quit = false;
+	for (int i = 1; i <= helpers; ++i) {
+		m_workers.push_back(std::make_unique<Worker>());
+	}
+	for (int i = 1; i <= helpers; ++i) {
+		m_workers[static_cast<std::size_t>(i)]->thread = std::thread(&JobManager::workerLoop, this, i);
+	}
+
+	Manager::startUp();
+	LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "JobManager started (%d workers)\n", getWorkerCount());
+	return 0;
+}
+
+// Stop and join helper threads.
+void JobManager::shutDown() {
+	LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "JobManager shutting down\n");
+	{
+		std::lock_guard<std::mutex> g(m_wake_lock);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+	for (std::size_t i = 1; i < m_workers.size(); ++i) {
+		if (m_workers[i]->thread.joinable()) m_workers[i]->thread.join();
+	}
+	m_workers.resize(1);
+	Manager::shutDown();
+}
+
+// Return number of threads taking part in parallelFor() (including caller).
+int JobManager::getWorkerCount() const {
+	return static_cast<int>(m_workers.size());
+}
+
+// Helper thread: sleep until a batch is posted, then drain/steal chunks.
+void JobManager::workerLoop(int index) {
+	unsigned seen = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> g(m_wake_lock);
+			m_wake.wait(g, [&] { return m_quit || m_generation != seen; });
+			if (m_quit) return;
+			seen = m_generation;
+		}
+		Chunk c;
+		while (takeChunk(index, c)) runChunk(index, c);
+	}
+}
+
+// Pop from own deque (back), else steal from another worker (front).
+bool JobManager::takeChunk(int index, Chunk& out) {
+	Worker& self = *m_workers[static_cast<std::size_t>(index)];
+	{
+		std::lock_guard<std::mutex> g(self.lock);
+		if (!self.chunks.empty()) {
+			out = self.chunks.back();
+			self.chunks.pop_back();
+			return true;
+		}
+	}
+	const int n = getWorkerCount();
+	for (int k = 1; k < n; ++k) {
+		Worker& victim = *m_workers[static_cast<std::size_t>((index + k) % n)];
+		std::lock_guard<std::mutex> g(victim.lock);
+		if (!victim.chunks.empty()) {
+			out = victim.chunks.front();
+			victim.chunks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+// Run every item of a chunk with this worker's job context set.
+// The span is recorded before the chunk counts as finished, so the caller
+// never reads trace buffers a helper is still writing.
+void JobManager::runChunk(int index, const Chunk& c) {
+	{
+		TraceScope trace("job");
+		t_worker = index;
+		for (int i = c.begin; i < c.end; ++i) {
+			t_item = i;
+			t_seq = 0;
+			(*c.p_body)(i);
+		}
+		t_worker = -1;
+	}
+	m_chunks_left.fetch_sub(1, std::memory_order_release);
+}
+
+// Run body(i) for every i in [0, count) across workers, then apply deferred work.
+void JobManager::parallelFor(int count, const Body& body, int grain) {
+	if (count <= 0) return;
+	if (grain < 1) grain = 1;
+
+	// Publish the chunk count before dealing: a helper still stealing from
+	// the previous batch may take and finish a chunk as soon as it is queued.
+	const int chunks = (count - 1) / grain + 1;
+	m_chunks_left.store(chunks, std::memory_order_release);
+
+	// Deal chunks round-robin so every worker starts with local work.
+	const int n = getWorkerCount();
+	for (int k = 0; k < chunks; ++k) {
+		const int begin = k * grain;
+		Worker& w = *m_workers[static_cast<std::size_t>(k % n)];
+		std::lock_guard<std::mutex> g(w.lock);
+		w.chunks.push_back(Chunk{ begin, std::min(begin + grain, count), &body });
+	}
+
+	if (n > 1) {
+		{
+			std::lock_guard<std::mutex> g(m_wake_lock);
+			++m_generation;
+		}
+		m_wake.notify_all();
+	}
+
+	// Caller works too, then waits for chunks still running elsewhere.
+	Chunk c;
+	while (takeChunk(0, c)) runChunk(0, c);
+	while (m_chunks_left.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+
+	// Merge deferred work and apply it in (item, seq) order.
+	m_apply.clear();
+	for (auto& w : m_workers) {
+		for (Deferred& d : w->scratch) m_apply.push_back(std::move(d));
+		w->scratch.clear();
+	}
+	std::sort(m_apply.begin(), m_apply.end(), [](const Deferred& a, const Deferred& b) {
+		return (a.item != b.item) ? a.item < b.item : a.seq < b.seq;
+	});
+	for (Deferred& d : m_apply) d.fn();
+	m_apply.clear();
+}
+
+// True if called from inside a parallelFor() job.
+bool JobManager::inParallelJob() {
+	return t_worker >= 0;
+}
+
+// Buffer fn until the current batch ends (inside a parallel job), otherwise run it now.
+void JobManager::defer(std::function<void()> fn) {
+	if (t_worker < 0) {
+		fn();
+		return;
+	}
+	Worker& w = *getInstance().m_workers[static_cast<std::size_t>(t_worker)];
+	w.scratch.push_back(Deferred{ t_item, t_seq++, std::move(fn) });
+}
+
+}
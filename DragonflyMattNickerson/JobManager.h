@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Manager.h"
+
+namespace df {
+
+	// Small work-stealing job system. parallelFor() splits a range into
+	// chunks, deals them to per-worker deques and lets idle workers steal.
+	// The calling thread takes part as worker 0.
+	//
+	// Code running inside a parallel job must not touch shared engine
+	// state directly; it hands such work to defer(). Deferred work is
+	// buffered per worker and applied on the calling thread after the
+	// batch, ordered by item index, so results don't depend on scheduling.
+	class JobManager : public Manager {
+	private:
+		JobManager();
+		JobManager(const JobManager&) = delete;
+		JobManager& operator=(const JobManager&) = delete;
+
+		using Body = std::function<void(int)>;
+
+		struct Chunk {
+			int begin;
+			int end;
+			const Body* p_body;
+		};
+
+		struct Deferred {
+			int item; // Item whose job issued it.
+			int seq; // Order within that item.
+			std::function<void()> fn;
+		};
+
+		struct Worker {
+			std::mutex lock;
+			std::deque<Chunk> chunks; // Owner pops back, thieves steal front.
+			std::vector<Deferred> scratch; // Deferred work from this worker's jobs.
+			std::thread thread;
+		};
+
+		std::vector<std::unique_ptr<Worker>> m_workers; // [0] is the calling thread.
+		int m_requested_threads; // Helper threads to start (-1 = hardware - 1).
+
+		std::mutex m_wake_lock;
+		std::condition_variable m_wake;
+		unsigned m_generation; // Bumped for every batch (guarded by m_wake_lock).
+		bool m_quit; // Guarded by m_wake_lock.
+		std::atomic<int> m_chunks_left; // Chunks of current batch not yet finished.
+		std::vector<Deferred> m_apply; // Merged deferred work (reused).
+
+		void workerLoop(int index);
+		bool takeChunk(int index, Chunk& out);
+		void runChunk(int index, const Chunk& c);
+
+	public:
+		// Join helper threads if shutDown() was never called.
+		~JobManager();
+
+
+		// Get the one and only instance of the JobManager.
+		static JobManager& getInstance();
+
+
+		// Start helper threads. Return 0 if ok, else -1.
+		int startUp() override;
+
+
+		// Stop and join helper threads.
+		void shutDown() override;
+
+
+		// Set helper thread count used by next startUp() (-1 = hardware threads - 1).
+		void setThreadCount(int count) { m_requested_threads = count; }
+
+
+		// Return number of threads taking part in parallelFor() (including caller).
+		int getWorkerCount() const;
+
+
+		// Run body(i) for every i in [0, count) across workers, then apply
+		// deferred work in item order. Must be called from one thread only.
+		void parallelFor(int count, const Body& body, int grain = 64);
+
+
+		// True if called from inside a parallelFor() job.
+		static bool inParallelJob();
+
+
+		// Buffer fn until the current batch ends (inside a parallel job),
+		// otherwise run it now.
+		static void defer(std::function<void()> fn);
+	};
+
+}
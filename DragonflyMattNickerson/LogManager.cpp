@@ -1,16 +1,19 @@
-
 #include "LogManager.h"
+#include <chrono>
 #include <cstdarg>
 #include <cstdio>
 
 namespace df {
 	// Default log file name.
 	LogManager::LogManager()
-		: m_do_flush(false), m_p_f(nullptr) {
+		: m_do_flush(false), m_p_f(nullptr),
+		m_level(LOG_DEBUG), m_categories(LOG_ALL),
+		m_claim(0), m_drain(0), m_async(false), m_stop_writer(false), m_dropped(0) {
 		setType("LogManager");
 	}
 
 	LogManager::~LogManager() {
+		stopWriter();
 		// Ensure file is closed if user forgot to call shutDown().
 		if (m_p_f) {
 			fclose(m_p_f);
@@ -32,6 +35,7 @@ namespace df {
 		errno_t err = fopen_s(&m_p_f, LOGFILE_NAME.c_str(), "w");
 		if (err != 0 || !m_p_f) return -1;
 
+		if (isAsync()) startWriter();
 		Manager::startUp();
 		return 0;
 	}
@@ -41,7 +45,8 @@ namespace df {
 		if (!isStarted()) {
 			return;
 		}
-		writeLog("LogManager shutting down");
+		writeLog(LOG_INFO, LOG_ENGINE, "LogManager shutting down");
+		stopWriter(); // Drains everything still queued.
 			if (m_p_f) {
 				fflush(m_p_f);
 				fclose(m_p_f);
@@ -51,27 +56,138 @@ namespace df {
 	}
 
 	// Set flush of logfile after each write.
-	void LogManager::setFlush(bool do_flush) { 
-		m_do_flush = do_flush; 
+	void LogManager::setFlush(bool do_flush) {
+		m_do_flush = do_flush;
 	}
 
-	// Write to logfile. Supports printf() formatting of strings.
-	int LogManager::writeLog(const char* fmt, ...) const {
+	// Switch modes from the main thread while no other thread is logging.
+	void LogManager::setAsync(bool async) {
+		if (async == isAsync()) return;
+		if (async) {
+			if (!m_p_ring) {
+				m_p_ring.reset(new Slot[LOG_ASYNC_SLOTS]);
+				for (int i = 0; i < LOG_ASYNC_SLOTS; i++)
+					m_p_ring[i].sequence.store(static_cast<unsigned>(i), std::memory_order_relaxed);
+			}
+			m_async.store(true);
+			if (m_p_f) startWriter();
+		}
+		else {
+			m_async.store(false);
+			stopWriter();
+		}
+	}
+
+	void LogManager::startWriter() {
+		if (m_writer.joinable()) return;
+		m_stop_writer.store(false);
+		m_writer = std::thread([this] { writerLoop(); });
+	}
+
+	// Stop the writer thread after it drains the ring.
+	void LogManager::stopWriter() {
+		if (!m_writer.joinable()) return;
+		m_stop_writer.store(true);
+		m_writer.join();
+	}
+
+	void LogManager::writerLoop() {
+		unsigned reported = m_dropped.load(std::memory_order_relaxed);
+		for (;;) {
+			const bool stopping = m_stop_writer.load(std::memory_order_acquire);
+			const int n = drain();
+
+			const unsigned dropped = m_dropped.load(std::memory_order_relaxed);
+			if (dropped != reported && m_p_f) {
+				fprintf(m_p_f, "LogManager: %u messages dropped (ring full)\n", dropped - reported);
+				reported = dropped;
+			}
+			if (n > 0 && m_do_flush && m_p_f) fflush(m_p_f);
+
+			if (stopping) break;
+			if (n == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		if (m_p_f) fflush(m_p_f);
+	}
+
+	// Write filled slots in claim order, stopping at the first slot whose
+	// producer is still formatting.
+	int LogManager::drain() {
+		if (!m_p_ring) return 0;
+		int count = 0;
+		for (;;) {
+			Slot& s = m_p_ring[m_drain & (LOG_ASYNC_SLOTS - 1)];
+			if (s.sequence.load(std::memory_order_acquire) != m_drain + 1) break;
+			if (m_p_f) fwrite(s.text, 1, static_cast<size_t>(s.length), m_p_f);
+			s.sequence.store(m_drain + LOG_ASYNC_SLOTS, std::memory_order_release);
+			++m_drain;
+			++count;
+		}
+		return count;
+	}
+
+	// Format and write (sync) or enqueue (async). Return characters
+	// written, or -1 on error or a full ring.
+	int LogManager::vwrite(const char* fmt, va_list args) const {
 		if (!m_p_f) {
 			return -1;
 		}
+
+		if (!m_async.load(std::memory_order_relaxed)) {
+			int written = vfprintf(m_p_f, fmt, args); // printf-style into FILE*
+			if (written < 0) {
+				return -1; // vfprintf error
+			}
+			if (m_do_flush) {
+				fflush(m_p_f);
+			}
+			return written;
+		}
+
+		// Claim a free slot; never wait for the writer.
+		unsigned pos = m_claim.load(std::memory_order_relaxed);
+		Slot* p_slot;
+		for (;;) {
+			p_slot = &m_p_ring[pos & (LOG_ASYNC_SLOTS - 1)];
+			const int diff = static_cast<int>(p_slot->sequence.load(std::memory_order_acquire) - pos);
+			if (diff == 0) {
+				if (m_claim.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			}
+			else if (diff < 0) {
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return -1;
+			}
+			else {
+				pos = m_claim.load(std::memory_order_relaxed);
+			}
+		}
+
+		int written = vsnprintf(p_slot->text, LOG_ASYNC_MESSAGE_MAX, fmt, args);
+		if (written < 0) written = 0;
+		p_slot->length = written < LOG_ASYNC_MESSAGE_MAX ? written : LOG_ASYNC_MESSAGE_MAX - 1;
+		p_slot->sequence.store(pos + 1, std::memory_order_release);
+		return written;
+	}
+
+	// Write to logfile. Supports printf() formatting of strings.
+	int LogManager::writeLog(const char* fmt, ...) const {
+		if (!isEnabled(LOG_INFO, LOG_GENERAL)) return 0;
 		va_list args;
 		va_start(args, fmt);
-		int written = vfprintf(m_p_f, fmt, args); // printf-style into FILE*
+		const int written = vwrite(fmt, args);
+		va_end(args);
+		return written;
+	}
+
+	// Write to logfile at a level and category, filtered before formatting.
+	int LogManager::writeLog(LogLevel level, LogCategory category, const char* fmt, ...) const {
+		if (!isEnabled(level, category)) return 0;
+		va_list args;
+		va_start(args, fmt);
+		const int written = vwrite(fmt, args);
 		va_end(args);
-		if (written < 0) {
-			return -1; // vfprintf error
-		}
-		if (m_do_flush) {
-			fflush(m_p_f);
-		}
 		return written;
 	}
 
 
-}
\ No newline at end of file
+}
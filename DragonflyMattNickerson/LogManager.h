@@ -1,6 +1,10 @@
 #pragma once
 #include <stdio.h>
+#include <atomic>
+#include <cstdarg>
+#include <memory>
 #include <string>
+#include <thread>
 #include "Manager.h"
 
 
@@ -11,15 +15,61 @@ namespace df {
 	const std::string LOGFILE_NAME = "dragonfly.log";
 
 
+	// Severity levels, least to most severe.
+	enum LogLevel { LOG_DEBUG = 0, LOG_INFO, LOG_WARNING, LOG_ERROR, LOG_NONE };
+
+
+	// Categories are bit flags so any set of them can be enabled at once.
+	enum LogCategory : unsigned {
+		LOG_GENERAL = 1u << 0,
+		LOG_ENGINE = 1u << 1,  // Manager start up / shut down.
+		LOG_WORLD = 1u << 2,   // Objects, movement, collisions.
+		LOG_INPUT = 1u << 3,
+		LOG_DISPLAY = 1u << 4,
+		LOG_GAME = 1u << 5,    // Game code.
+		LOG_ALL = ~0u
+	};
+
+
+	// Slots in the async ring (a power of two), and the longest message a
+	// slot holds. Longer async messages are truncated.
+	const int LOG_ASYNC_SLOTS = 4096;
+	const int LOG_ASYNC_MESSAGE_MAX = 256;
+
+
 	class LogManager : public Manager {
 	private:
 		LogManager(); // Private since a singleton.
-		LogManager(const LogManager&) = delete; 
-		LogManager& operator=(const LogManager&) = delete; 
+		LogManager(const LogManager&) = delete;
+		LogManager& operator=(const LogManager&) = delete;
 
 
 		bool m_do_flush; // True if flush to disk after each write.
 		FILE* m_p_f; // Pointer to logfile struct.
+		std::atomic<int> m_level; // Messages below this level are dropped.
+		std::atomic<unsigned> m_categories; // Enabled category mask.
+
+		// Async mode: bounded lock-free multi-producer ring drained by one
+		// writer thread. A slot's sequence says whose turn it is: equal to
+		// the claim position when free, position + 1 once filled.
+		struct Slot {
+			std::atomic<unsigned> sequence;
+			int length;
+			char text[LOG_ASYNC_MESSAGE_MAX];
+		};
+		std::unique_ptr<Slot[]> m_p_ring;
+		mutable std::atomic<unsigned> m_claim; // Next position producers claim.
+		unsigned m_drain; // Next position the writer reads (writer only).
+		std::atomic<bool> m_async;
+		std::atomic<bool> m_stop_writer;
+		mutable std::atomic<unsigned> m_dropped; // Messages lost to a full ring.
+		std::thread m_writer;
+
+		void startWriter();
+		void stopWriter();
+		void writerLoop();
+		int drain(); // Write out filled slots in order; return count.
+		int vwrite(const char* fmt, va_list args) const;
 
 
 	public:
@@ -39,13 +89,45 @@ namespace df {
 		void shutDown();
 
 
-		// Set flush of logfile after each write.
+		// Set flush of logfile after each write. In async mode the writer
+		// flushes once per batch instead.
 		void setFlush(bool do_flush = true);
 
 
+		// Set async mode: writeLog() formats into a lock-free ring and a
+		// background thread writes it out, so callers never wait on the
+		// disk. A full ring drops messages rather than block.
+		void setAsync(bool async = true);
+		bool isAsync() const { return m_async.load(std::memory_order_relaxed); }
+
+
+		// Set minimum level and enabled categories.
+		void setLevel(LogLevel level) { m_level.store(level, std::memory_order_relaxed); }
+		void setCategories(unsigned mask) { m_categories.store(mask, std::memory_order_relaxed); }
+		LogLevel getLevel() const { return static_cast<LogLevel>(m_level.load(std::memory_order_relaxed)); }
+		unsigned getCategories() const { return m_categories.load(std::memory_order_relaxed); }
+
+
+		// True if a message at this level and category would be written.
+		// Checked before any formatting.
+		bool isEnabled(LogLevel level, LogCategory category) const {
+			return level >= m_level.load(std::memory_order_relaxed)
+				&& (category & m_categories.load(std::memory_order_relaxed)) != 0;
+		}
+
+
+		// Messages dropped because the async ring was full.
+		unsigned getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+
 		// Write to logfile. Supports printf() formatting of strings.
+		// Logged as LOG_INFO in LOG_GENERAL. Safe to call from any thread.
 		int writeLog(const char* fmt, ...) const;
+
+
+		// Write to logfile at a level and category. Return 0 if filtered out.
+		int writeLog(LogLevel level, LogCategory category, const char* fmt, ...) const;
 	};
 
 
-}
\ No newline at end of file
+}
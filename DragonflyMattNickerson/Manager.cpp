@@ -1,5 +1,8 @@
 #include "Manager.h"
 #include "Event.h"
+#include "Object.h"
+#include "ObjectListView.h"
+#include "TraceManager.h"
 
 
 namespace df {
@@ -28,6 +31,44 @@ namespace df {
 	// returns true if started, else false
 	bool Manager::isStarted() const { return m_is_started; }
 
+	// Send event to all Objects interested in its type. Return count of Objects sent to.
+	int Manager::onEvent(const Event& e) {
+		TraceScope trace(e.getTypeName(), "onEvent");
+		int count = 0;
+		for (Object* o : getInterested(e.getTypeId())) {
+			if (o) { o->onEvent(e); ++count; }
+		}
+		return count;
+	}
+
+	// Return view of Objects interested in event type.
+	ObjectListView Manager::getInterested(int event_type) const {
+		static const ObjectList none;
+		if (event_type < 0 || static_cast<std::size_t>(event_type) >= m_interest.size())
+			return ObjectListView(none);
+		return ObjectListView(m_interest[static_cast<std::size_t>(event_type)]);
+	}
+
+	// Base Manager accepts any event type.
+	bool Manager::isValid(int event_type) const {
+		(void)event_type;
+		return true;
+	}
+
+	// Register Object as interested in event type. Return handle (invalid if not ok).
+	ObjectHandle Manager::registerInterest(Object* p_o, int event_type) {
+		if (p_o == nullptr || event_type < 0 || !isValid(event_type)) return ObjectHandle();
+		const std::size_t type = static_cast<std::size_t>(event_type);
+		if (type >= m_interest.size()) m_interest.resize(type + 1); // deque: existing lists stay put
+		return m_interest[type].insertHandle(p_o);
+	}
+
+	// Unregister interest previously registered under handle. Return 0 if ok, else -1.
+	int Manager::unregisterInterest(ObjectHandle handle, int event_type) {
+		if (event_type < 0 || static_cast<std::size_t>(event_type) >= m_interest.size()) return -1;
+		return m_interest[static_cast<std::size_t>(event_type)].remove(handle);
+	}
+
 
 }
 
@@ -1,7 +1,11 @@
 #pragma once
+#include <deque>
 #include <string>
+#include "ObjectList.h"
+#include "ObjectListView.h"
 
 class Event;
+class Object;
 
 namespace df {
 
@@ -9,6 +13,7 @@ namespace df {
 	private:
 		std::string m_type; // Manager type identifier
 		bool m_is_started; // True when started successfully
+		std::deque<ObjectList> m_interest; // Objects interested in each event type id
 
 
 	protected:
@@ -16,6 +21,10 @@ namespace df {
 		void setType(std::string type);
 
 
+		// Return view of Objects interested in event type.
+		ObjectListView getInterested(int event_type) const;
+
+
 	public:
 		Manager();
 		virtual ~Manager();
@@ -36,8 +45,20 @@ namespace df {
 		// Return true when startUp() was executed ok, else false.
 		bool isStarted() const;
 
-		// Handle event (default does nothing). Return 0 if ignored, else 1.
-		virtual int onEvent(const Event& e) { (void)e; return 0; }
+		// Send event to all Objects interested in its type. Return count of Objects sent to.
+		virtual int onEvent(const Event& e);
+
+
+		// Return true if event type is handled by this Manager.
+		virtual bool isValid(int event_type) const;
+
+
+		// Register Object as interested in event type. Return handle (invalid if not ok).
+		ObjectHandle registerInterest(Object* p_o, int event_type);
+
+
+		// Unregister interest previously registered under handle. Return 0 if ok, else -1.
+		int unregisterInterest(ObjectHandle handle, int event_type);
 
 	};
 
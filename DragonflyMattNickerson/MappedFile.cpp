@@ -0,0 +1,70 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Map file at path. Return 0 if ok, else -1 (missing or empty file).
+int MappedFile::open(const std::string& path) {
+	close();
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return -1;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+		CloseHandle(file);
+		return -1;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		CloseHandle(file);
+		return -1;
+	}
+	const void* p_view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!p_view) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return -1;
+	}
+	m_file = file;
+	m_mapping = mapping;
+	m_p_data = static_cast<const char*>(p_view);
+	m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return -1;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		::close(fd);
+		return -1;
+	}
+	void* p_view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // The mapping keeps the file alive.
+	if (p_view == MAP_FAILED) return -1;
+	m_p_data = static_cast<const char*>(p_view);
+	m_size = static_cast<std::size_t>(st.st_size);
+#endif
+	return 0;
+}
+
+// Unmap (no-op if nothing is mapped).
+void MappedFile::close() {
+	if (!m_p_data) return;
+#if defined(_WIN32)
+	UnmapViewOfFile(m_p_data);
+	CloseHandle(static_cast<HANDLE>(m_mapping));
+	CloseHandle(static_cast<HANDLE>(m_file));
+	m_mapping = nullptr;
+	m_file = nullptr;
+#else
+	munmap(const_cast<char*>(m_p_data), m_size);
+#endif
+	m_p_data = nullptr;
+	m_size = 0;
+}
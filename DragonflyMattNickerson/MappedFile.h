@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+
+// Read-only memory mapping of a whole file (mmap, or a file mapping on
+// Windows). The bytes stay valid until close() or destruction.
+class MappedFile {
+private:
+	const char* m_p_data{ nullptr };
+	std::size_t m_size{ 0 };
+#if defined(_WIN32)
+	void* m_file{ nullptr }; // HANDLE of the open file.
+	void* m_mapping{ nullptr }; // HANDLE of its mapping.
+#endif
+
+public:
+	MappedFile() = default;
+	~MappedFile() { close(); }
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+
+	// Map file at path. Return 0 if ok, else -1 (missing or empty file).
+	int open(const std::string& path);
+
+
+	// Unmap (no-op if nothing is mapped).
+	void close();
+
+
+	// Mapped bytes (nullptr if nothing is mapped) and their count.
+	const char* getData() const { return m_p_data; }
+	std::size_t getSize() const { return m_size; }
+};
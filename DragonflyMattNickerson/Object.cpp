@@ -1,9 +1,32 @@
 #include "Object.h"
 #include "WorldManager.h"
+#include "TypeRegistry.h"
+#include "GameManager.h"
+#include "JobManager.h"
+#include "InputManager.h"
+#include "EventStep.h"
+#include "EventKeyboard.h"
+#include "EventMouse.h"
 
 
 int Object::s_next_id = 0;
 
+namespace {
+    // Type id for plain "Object", interned once.
+    int defaultTypeId() {
+        static const int id = TypeRegistry::getInstance().intern("Object");
+        return id;
+    }
+
+    // Manager responsible for dispatching an event type.
+    df::Manager& managerFor(int event_type) {
+        if (event_type == EventStep::TYPE_ID) return df::GameManager::getInstance();
+        if (event_type == EventKeyboard::TYPE_ID || event_type == EventMouse::TYPE_ID)
+            return df::InputManager::getInstance();
+        return WM();
+    }
+}
+
 int Object::onEvent(const Event& e) {
 	(void)e;
 	return 0;
@@ -11,19 +34,50 @@ int Object::onEvent(const Event& e) {
 // Create Object with default values and add to WorldManager.
 Object::Object()
     : m_id(s_next_id++),
-    m_type("Object"),
-    m_position(0.f, 0.f),
-    m_marked(false),
-    m_solidness(Solidness::HARD),
-    m_altitude(0),
-    m_vx(0.0f),
-    m_vy(0.0f) {
+    m_type_id(defaultTypeId()),
+    m_transform(TransformStore::getInstance().add(this)),
+    m_box(Vector(0, 0), 1, 1),
+    m_marked(false) {
+    setSolidness(Solidness::HARD);
     addToWorld();
 }
 
 // Remove Object from WorldManager.
 Object::~Object() {
+	for (const Interest& i : m_interests)
+		i.p_manager->unregisterInterest(i.handle, i.event_type);
 	removeFromWorld();
+	TransformStore::getInstance().remove(m_transform);
+}
+
+// Register for interest in event type. Return 0 if ok, else -1.
+int Object::registerInterest(int event_type) {
+	for (const Interest& i : m_interests)
+		if (i.event_type == event_type) return 0; // already registered
+
+	df::Manager& m = managerFor(event_type);
+	if (!m_active) { // parked: registered for real on reactivation
+		if (!m.isValid(event_type)) return -1;
+		m_interests.push_back(Interest{ event_type, &m, ObjectHandle() });
+		return 0;
+	}
+	const ObjectHandle h = m.registerInterest(this, event_type);
+	if (!h.isValid()) return -1;
+	m_interests.push_back(Interest{ event_type, &m, h });
+	return 0;
+}
+
+// Unregister for interest in event type. Return 0 if ok, else -1.
+int Object::unregisterInterest(int event_type) {
+	for (std::size_t i = 0; i < m_interests.size(); ++i) {
+		if (m_interests[i].event_type == event_type) {
+			m_interests[i].p_manager->unregisterInterest(m_interests[i].handle, event_type);
+			m_interests[i] = m_interests.back();
+			m_interests.pop_back();
+			return 0;
+		}
+	}
+	return -1;
 }
 
 // Set and get id.
@@ -31,29 +85,50 @@ void Object::setId(int new_id) { m_id = new_id; }
 int Object::getId() const { return m_id; }
 
 // Set and get type.
-void Object::setType(std::string new_type) { m_type = std::move(new_type); }
-std::string Object::getType() const { return m_type; }
+void Object::setType(std::string new_type) {
+    if (df::JobManager::inParallelJob()) { // Interning touches the shared TypeRegistry.
+        df::JobManager::defer([this, new_type] { setType(new_type); });
+        return;
+    }
+    const int new_id = TypeRegistry::getInstance().intern(new_type);
+    WM().updateType(this, m_type_id, new_id);
+    m_type_id = new_id;
+}
+const std::string& Object::getType() const { return TypeRegistry::getInstance().getName(m_type_id); }
 
 // Set and get position.
-void Object::setPosition(Vector new_pos) { m_position = new_pos; }
-Vector Object::getPosition() const { return m_position; }
+void Object::setPosition(Vector new_pos) {
+    TransformStore& ts = TransformStore::getInstance();
+    WM().updatePosition(this, ts.getPosition(m_transform), new_pos);
+    ts.setPosition(m_transform, new_pos);
+}
+
+// Set bounding box (relative to position).
+void Object::setBox(const Box& box) {
+    m_box = box;
+    WM().updateBox(this);
+}
 
 // Add/remove self to/from world.
 void Object::addToWorld() { WM().insertObject(this); }
 void Object::removeFromWorld() { WM().removeObject(this); }
 
 // Mark for deletion via WorldManager deferred removal.
-void Object::markForDelete() { m_marked = true; WM().markForDelete(this); }
+void Object::markForDelete() { WM().markForDelete(this); }
+
+// Park for reuse via WorldManager deferred deactivation.
+void Object::deactivate() { WM().markForDeactivate(this); }
 
-void Object::setSolidness(Solidness s) { m_solidness = s; }
-Solidness Object::getSolidness() const { return m_solidness; }
-bool Object::isSolid() const { return m_solidness != Solidness::SPECTRAL; }
+void Object::setSolidness(Solidness s) {
+    TransformStore::getInstance().setSolidness(m_transform, static_cast<std::uint8_t>(s));
+}
 
-void Object::setAltitude(int a) { m_altitude = a; }
-int Object::getAltitude() const { return m_altitude; }
+void Object::setAltitude(int a) {
+    TransformStore& ts = TransformStore::getInstance();
+    WM().updateAltitude(this, ts.getAltitude(m_transform), a);
+    ts.setAltitude(m_transform, a);
+}
 
-void Object::setVelocityX(float vx) { m_vx = vx; }
-void Object::setVelocityY(float vy) { m_vy = vy; }
-void Object::setVelocity(float vx, float vy) { m_vx = vx; m_vy = vy; }
-float Object::getVelocityX() const { return m_vx; }
-float Object::getVelocityY() const { return m_vy; }
\ No newline at end of file
+void Object::setVelocityX(float vx) { TransformStore::getInstance().setVelocityX(m_transform, vx); }
+void Object::setVelocityY(float vy) { TransformStore::getInstance().setVelocityY(m_transform, vy); }
+void Object::setVelocity(float vx, float vy) { setVelocityX(vx); setVelocityY(vy); }
\ No newline at end of file
@@ -1,9 +1,15 @@
 #pragma once
+#include <cstddef>
 #include <string>
+#include <vector>
 #include "Vector.h"
+#include "Box.h"
+#include "ObjectHandle.h"
+#include "TransformStore.h"
 
 
 class Event;  
+namespace df { class Manager; }
 
 enum class Solidness {
 	HARD,     
@@ -12,16 +18,30 @@ enum class Solidness {
 };
 
 class Object {
+	friend class WorldManager; // Maintains world handle and deletion mark.
+	friend class TransformStore; // Repoints m_transform when entries move.
+
 private:
 	int m_id; // Unique game engine defined identifier.
-	std::string m_type; // Game programmer defined type.
-	Vector m_position; // Position in game world.
+	int m_type_id; // Game programmer defined type (interned in TypeRegistry).
+	int m_transform; // Index of position/velocity/solidness/altitude in TransformStore.
+	int m_proxy = -1; // Leaf in WorldManager's collision tree (-1 if not in world).
+	Box m_box; // Bounding box relative to position (default one cell).
 	bool m_marked = false; // For deferred deletion (engine convenience).
-
-	Solidness   m_solidness{ Solidness::HARD };
-	int         m_altitude{ 0 };        
-	float       m_vx{ 0.0f };
-	float       m_vy{ 0.0f };
+	bool m_parallel_step = false; // Step handler may run on a JobManager worker.
+	bool m_active = true; // False while parked in WorldManager's recycle list.
+	bool m_deactivating = false; // Queued for deactivation at end of update().
+	ObjectHandle m_handle; // Handle into WorldManager storage (invalid if not in world).
+	ObjectHandle m_type_handle; // Handle into WorldManager per-type bucket.
+	ObjectHandle m_altitude_handle; // Handle into WorldManager per-altitude draw bucket.
+
+	// Event type this Object registered interest in, and where.
+	struct Interest {
+		int event_type;
+		df::Manager* p_manager;
+		ObjectHandle handle;
+	};
+	std::vector<Interest> m_interests;
 
 	static int s_next_id; // static counter for unique ids
 
@@ -34,6 +54,9 @@ public:
 	// Destroy Object. Remove from game world (WorldManager).
 	virtual ~Object();
 
+	Object(const Object&) = delete;
+	Object& operator=(const Object&) = delete;
+
 
 	// Set Object id.
 	void setId(int new_id);
@@ -43,12 +66,20 @@ public:
 	int getId() const;
 
 
+	// Get stable handle to this Object (resolve with WorldManager::getObject()).
+	ObjectHandle getHandle() const { return m_handle; }
+
+
 	// Set type identifier of Object.
 	void setType(std::string new_type);
 
 
 	// Get type identifier of Object.
-	std::string getType() const;
+	const std::string& getType() const;
+
+
+	// Get interned type id of Object (see TypeRegistry).
+	int getTypeId() const { return m_type_id; }
 
 
 	// Set position of Object.
@@ -56,7 +87,25 @@ public:
 
 
 	// Get position of Object.
-	Vector getPosition() const;
+	Vector getPosition() const { return TransformStore::getInstance().getPosition(m_transform); }
+
+
+	// Set bounding box, relative to position. Collisions test these boxes,
+	// so an Object can cover many cells. Default is the single cell at
+	// position (corner (0,0), 1x1).
+	void setBox(const Box& box);
+	const Box& getBox() const { return m_box; }
+
+
+	// Bounding box in world space, at the cell position (or where) is in.
+	Box getWorldBox() const { return getWorldBox(getPosition()); }
+	Box getWorldBox(const Vector& where) const {
+		// Anchor at the truncated cell, as positions are drawn and tested.
+		const float x = static_cast<float>(static_cast<int>(where.getX()));
+		const float y = static_cast<float>(static_cast<int>(where.getY()));
+		return Box(Vector(x + m_box.getCorner().getX(), y + m_box.getCorner().getY()),
+			m_box.getHorizontal(), m_box.getVertical());
+	}
 
 
 	// Add/remove self to/from world explicitly (helper methods).
@@ -65,23 +114,60 @@ public:
 
 	virtual int onEvent(const Event& e);
 
+
+	// Register for interest in event type (only interested Objects receive
+	// step, keyboard, mouse and custom events). Return 0 if ok, else -1.
+	int registerInterest(int event_type);
+
+
+	// Unregister for interest in event type. Return 0 if ok, else -1.
+	int unregisterInterest(int event_type);
+
 	void        setSolidness(Solidness s);
-	Solidness   getSolidness() const;
-	bool        isSolid() const;  
+	Solidness   getSolidness() const {
+		return static_cast<Solidness>(TransformStore::getInstance().getSolidness(m_transform));
+	}
+	bool        isSolid() const { return getSolidness() != Solidness::SPECTRAL; }
 
 	void        setAltitude(int a);
-	int         getAltitude() const;
+	int         getAltitude() const { return TransformStore::getInstance().getAltitude(m_transform); }
 
 	void        setVelocityX(float vx);
 	void        setVelocityY(float vy);
 	void        setVelocity(float vx, float vy);
-	float       getVelocityX() const;
-	float       getVelocityY() const;
+	float       getVelocityX() const { return TransformStore::getInstance().getVelocityX(m_transform); }
+	float       getVelocityY() const { return TransformStore::getInstance().getVelocityY(m_transform); }
+
+
+	// Allow onEvent(EventStep) to run in parallel with other Objects'.
+	// The handler may only change this Object; markForDelete(), setPosition(),
+	// setBox(), setAltitude() and the moving-set side of setVelocity*() are
+	// buffered automatically. setType() is deferred as a whole, so getType()
+	// returns the old type until the batch ends. Anything else that touches
+	// shared state (spawning, interest) must use JobManager::defer().
+	void setParallelStep(bool parallel = true) { m_parallel_step = parallel; }
+	bool isParallelStep() const { return m_parallel_step; }
 
 
 	// Mark for deletion via WorldManager deferred removal.
 	void markForDelete();
 	bool isMarkedForDelete() const { return m_marked; }
 
+
+	// Park Object for reuse instead of deleting it. At the end of the
+	// current update() it leaves the world (update, draw, collisions and
+	// event dispatch no longer see it) but keeps its type, transform entry
+	// and interest registrations, ready for WorldManager::reactivate().
+	void deactivate();
+	bool isActive() const { return m_active; }
+
 	virtual int draw() { return 0;}
+
+
+	// Snapshot payload hook (see WorldManager::saveSnapshot()): append
+	// per-type state beyond the transform to out, and restore it from the
+	// same bytes on load. loadPayload() returns 0 if ok, else -1. Default
+	// is no payload.
+	virtual void savePayload(std::vector<char>&) const {}
+	virtual int loadPayload(const char*, std::size_t) { return 0; }
 };
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+
+// Stable reference to an Object stored in an ObjectList.
+// Resolves in O(1) and goes stale once the Object is removed,
+// even if its slot is later reused by another Object.
+struct ObjectHandle {
+	static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+	std::uint32_t index{ INVALID_INDEX }; // Slot in owning list.
+	std::uint32_t generation{ 0 }; // Slot generation when handle was issued.
+
+	bool isValid() const { return index != INVALID_INDEX; }
+
+	bool operator==(const ObjectHandle& other) const {
+		return index == other.index && generation == other.generation;
+	}
+	bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+};
@@ -1,45 +1,124 @@
 #include "ObjectList.h"
+#include <algorithm>
 
 // Default constructor
-ObjectList::ObjectList() : m_count(0) {}
+ObjectList::ObjectList() : m_free_head(ObjectHandle::INVALID_INDEX) {}
 
-// Clear list (setting count to 0).
+// Clear list (setting count to 0). Outstanding handles go stale.
 void ObjectList::clear() {
-	for (int i = 0; i < m_count; ++i) m_p_obj[i] = nullptr;
-	m_count = 0;
+	while (!m_p_obj.empty())
+		removeAt(static_cast<std::uint32_t>(m_p_obj.size() - 1));
 }
+
+// Make room for count objects in total.
+void ObjectList::reserve(int count) {
+	if (count <= 0) return;
+	const std::size_t n = static_cast<std::size_t>(count);
+	m_p_obj.reserve(n);
+	m_slot_of.reserve(n);
+	m_slots.reserve(n);
+}
+
+// Reorder objects by less. Sorts the slot order, then moves objects and
+// repoints slots to match.
+void ObjectList::sort(bool (*less)(const Object*, const Object*)) {
+	std::sort(m_slot_of.begin(), m_slot_of.end(), [this, less](std::uint32_t a, std::uint32_t b) {
+		return less(m_p_obj[m_slots[a].dense], m_p_obj[m_slots[b].dense]);
+	});
+	static thread_local std::vector<Object*> s_old; // Reused, so warm sorts don't allocate.
+	s_old.assign(m_p_obj.begin(), m_p_obj.end());
+	for (std::size_t i = 0; i < m_p_obj.size(); ++i) m_p_obj[i] = s_old[m_slots[m_slot_of[i]].dense];
+	for (std::size_t i = 0; i < m_slot_of.size(); ++i) m_slots[m_slot_of[i]].dense = static_cast<std::uint32_t>(i);
+}
+
+// Remove dense entry i (swap-and-pop) and release its slot.
+void ObjectList::removeAt(std::uint32_t i) {
+	const std::uint32_t slot = m_slot_of[i];
+	const std::uint32_t last = static_cast<std::uint32_t>(m_p_obj.size() - 1);
+
+	// Move last entry into the hole and repoint its slot.
+	m_p_obj[i] = m_p_obj[last];
+	m_slot_of[i] = m_slot_of[last];
+	m_slots[m_slot_of[i]].dense = i;
+	m_p_obj.pop_back();
+	m_slot_of.pop_back();
+
+	// Free the slot; bumping the generation invalidates old handles.
+	++m_slots[slot].generation;
+	m_slots[slot].dense = m_free_head;
+	m_free_head = slot;
+}
+
 // Remove object pointer from list. Return 0 if found, else -1.
 int ObjectList::remove(Object* p_o) {
-	if (m_count <= 0 || p_o == nullptr) return -1;
-	for (int i = 0; i < m_count; ++i) {
+	if (m_p_obj.empty() || p_o == nullptr) return -1;
+	for (std::uint32_t i = 0; i < m_p_obj.size(); ++i) {
 		if (m_p_obj[i] == p_o) {
-			for (int j = i; j < m_count - 1; ++j)
-				m_p_obj[j] = m_p_obj[j + 1];
-			--m_count;
-			m_p_obj[m_count] = nullptr;      // clear vacated tail slot
+			removeAt(i);
 			return 0;
 		}
 	}
 	return -1;
 }
 
+// Remove object by handle in O(1). Return 0 if handle was live, else -1.
+int ObjectList::remove(ObjectHandle handle) {
+	if (get(handle) == nullptr) return -1;
+	removeAt(m_slots[handle.index].dense);
+	return 0;
+}
+
+// Return object referred to by handle (nullptr if stale).
+Object* ObjectList::get(ObjectHandle handle) const {
+	if (handle.index >= m_slots.size()) return nullptr;
+	const Slot& s = m_slots[handle.index];
+	if (s.generation != handle.generation || s.dense >= m_p_obj.size()) return nullptr;
+	if (m_slot_of[s.dense] != handle.index) return nullptr;
+	return m_p_obj[s.dense];
+}
+
+// Return handle of object at index i (invalid if out of range).
+ObjectHandle ObjectList::getHandle(int i) const {
+	if (i < 0 || i >= getCount()) return ObjectHandle();
+	const std::uint32_t slot = m_slot_of[i];
+	return ObjectHandle{ slot, m_slots[slot].generation };
+}
+
 // Return count of number of objects in list.
-int ObjectList::getCount() const { return m_count; }
+int ObjectList::getCount() const { return static_cast<int>(m_p_obj.size()); }
 
 // Insert object pointer in list. Return 0 if ok, else -1.
 int ObjectList::insert(Object* p_o) {
-	if (m_count >= MAX_OBJECTS || p_o == nullptr) return -1;
-	m_p_obj[m_count++] = p_o;
-	return 0;
+	return insertHandle(p_o).isValid() ? 0 : -1;
+}
+
+// Insert object pointer in list. Return its handle (invalid if not inserted).
+ObjectHandle ObjectList::insertHandle(Object* p_o) {
+	if (p_o == nullptr) return ObjectHandle();
+
+	std::uint32_t slot;
+	if (m_free_head != ObjectHandle::INVALID_INDEX) {
+		slot = m_free_head;
+		m_free_head = m_slots[slot].dense;
+	}
+	else {
+		slot = static_cast<std::uint32_t>(m_slots.size());
+		m_slots.push_back(Slot{ 0, 0 });
+	}
+
+	m_slots[slot].dense = static_cast<std::uint32_t>(m_p_obj.size());
+	m_p_obj.push_back(p_o);
+	m_slot_of.push_back(slot);
+	return ObjectHandle{ slot, m_slots[slot].generation };
 }
 
 // Index operator (with bounds checking). Returns pointer to Object.
 Object* ObjectList::operator[](int i) {
-	if (i < 0 || i >= m_count) throw std::out_of_range("ObjectList index out of range");
+	if (i < 0 || i >= getCount()) throw std::out_of_range("ObjectList index out of range");
 	return m_p_obj[i];
 }
 const Object* ObjectList::operator[](int i) const {
-	if (i < 0 || i >= m_count)
+	if (i < 0 || i >= getCount())
 		throw std::out_of_range("ObjectList index out of range");
 	return m_p_obj[i];
 }
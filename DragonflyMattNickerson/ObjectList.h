@@ -1,15 +1,29 @@
 #pragma once
 #include "Object.h"
+#include "ObjectHandle.h"
+#include <cassert>
+#include <cstdint>
 #include <stdexcept>
+#include <vector>
 
 
-const int MAX_OBJECTS = 1000;
-
-
+// Growable slot map of Object pointers.
+// Objects are kept densely packed for iteration; removal swaps the last
+// Object into the hole, so iteration order is not preserved across removes.
 class ObjectList {
 private:
-	int m_count; // Count of objects in list.
-	Object* m_p_obj[MAX_OBJECTS]{}; // Array of pointers to objects.
+	struct Slot {
+		std::uint32_t dense; // Index into m_p_obj when live, next free slot when free.
+		std::uint32_t generation; // Bumped every time the slot is freed.
+	};
+
+	std::vector<Object*> m_p_obj; // Dense array of pointers to objects.
+	std::vector<std::uint32_t> m_slot_of; // Slot owning each dense entry.
+	std::vector<Slot> m_slots; // Sparse slots referenced by handles.
+	std::uint32_t m_free_head; // First free slot (INVALID_INDEX if none).
+
+	// Remove dense entry i (swap-and-pop) and release its slot.
+	void removeAt(std::uint32_t i);
 
 
 public:
@@ -21,20 +35,51 @@ public:
 	int insert(Object* p_o);
 
 
+	// Insert object pointer in list. Return its handle (invalid if not inserted).
+	ObjectHandle insertHandle(Object* p_o);
+
+
 	// Remove object pointer from list. Return 0 if found, else -1.
 	int remove(Object* p_o);
 
 
-	// Clear list (setting count to 0).
+	// Remove object by handle in O(1). Return 0 if handle was live, else -1.
+	int remove(ObjectHandle handle);
+
+
+	// Return object referred to by handle (nullptr if stale).
+	Object* get(ObjectHandle handle) const;
+
+
+	// Return handle of object at index i (invalid if out of range).
+	ObjectHandle getHandle(int i) const;
+
+
+	// Clear list (setting count to 0). Outstanding handles go stale.
 	void clear();
 
 
+	// Make room for count objects in total, so inserts up to it do not reallocate.
+	void reserve(int count);
+
+
+	// Reorder objects by less (a strict weak order). Handles stay valid.
+	void sort(bool (*less)(const Object*, const Object*));
+
+
 	// Return count of number of objects in list.
 	int getCount() const;
 
 
 	// Index operator (with bounds checking). Returns pointer to Object.
 	Object* operator[](int i);
-	const Object* operator[](int i) const;  // <-- add this
+	const Object* operator[](int i) const;
+
+
+	// Index without range check in release builds (asserts in debug).
+	Object* getUnchecked(int i) const {
+		assert(i >= 0 && i < getCount());
+		return m_p_obj[static_cast<std::size_t>(i)];
+	}
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include "ObjectList.h"
+
+
+// Non-owning, read-only view over the Objects in an ObjectList.
+// Nothing is copied; the view reads the list's storage as it iterates.
+// Objects inserted while iterating are not visited, and the view stops
+// early if the list shrinks, so it stays safe when event handlers spawn
+// Objects. Element access is unchecked in release builds.
+class ObjectListView {
+private:
+	const ObjectList* m_p_list; // List being viewed (never null).
+	int m_count; // Number of Objects when the view was taken.
+
+public:
+	class Iterator {
+	private:
+		const ObjectList* m_p_list;
+		int m_index;
+
+	public:
+		Iterator(const ObjectList* p_list, int index) : m_p_list(p_list), m_index(index) {}
+
+		Object* operator*() const { return m_p_list->getUnchecked(m_index); }
+		Iterator& operator++() { ++m_index; return *this; }
+
+		// "Not at end" also fails once the index runs off a shrunken list.
+		bool operator!=(const Iterator& end) const {
+			return m_index < end.m_index && m_index < m_p_list->getCount();
+		}
+	};
+
+	explicit ObjectListView(const ObjectList& list)
+		: m_p_list(&list), m_count(list.getCount()) {
+	}
+
+	Iterator begin() const { return Iterator(m_p_list, 0); }
+	Iterator end() const { return Iterator(m_p_list, m_count); }
+
+	// Return count of number of objects in view.
+	int getCount() const { return m_count; }
+
+	// Unchecked index (asserts in debug). Returns pointer to Object.
+	Object* operator[](int i) const { return m_p_list->getUnchecked(i); }
+};
@@ -0,0 +1,71 @@
+#include "PoolAllocator.h"
+
+
+namespace df {
+
+	bool PoolAllocator::s_batching = false;
+	std::vector<PoolAllocator*> PoolAllocator::s_batch_pools;
+
+	PoolAllocator::PoolAllocator(std::size_t block_size, int blocks_per_slab)
+		: m_blocks_per_slab(blocks_per_slab > 0 ? blocks_per_slab : 1),
+		m_free(nullptr), m_pending(nullptr), m_pending_tail(nullptr), m_live(0) {
+		// Round up so every block stays aligned for any fundamental type.
+		const std::size_t align = alignof(std::max_align_t);
+		if (block_size < sizeof(FreeBlock)) block_size = sizeof(FreeBlock);
+		m_block_size = (block_size + align - 1) / align * align;
+	}
+
+	PoolAllocator::~PoolAllocator() {
+		for (void* slab : m_slabs) ::operator delete(slab);
+	}
+
+	// Add a slab and thread its blocks onto the free list in address order.
+	void PoolAllocator::grow() {
+		char* slab = static_cast<char*>(::operator new(m_block_size * static_cast<std::size_t>(m_blocks_per_slab)));
+		m_slabs.push_back(slab);
+		for (int i = m_blocks_per_slab - 1; i >= 0; --i) {
+			FreeBlock* b = reinterpret_cast<FreeBlock*>(slab + m_block_size * static_cast<std::size_t>(i));
+			b->next = m_free;
+			m_free = b;
+		}
+	}
+
+	void* PoolAllocator::allocate() {
+		if (!m_free) grow();
+		FreeBlock* b = m_free;
+		m_free = b->next;
+		++m_live;
+		return b;
+	}
+
+	void PoolAllocator::deallocate(void* p) {
+		FreeBlock* b = static_cast<FreeBlock*>(p);
+		--m_live;
+		if (!s_batching) {
+			b->next = m_free;
+			m_free = b;
+			return;
+		}
+		if (!m_pending) {
+			m_pending_tail = b;
+			s_batch_pools.push_back(this);
+		}
+		b->next = m_pending;
+		m_pending = b;
+	}
+
+	void PoolAllocator::beginBatch() {
+		s_batching = true;
+	}
+
+	void PoolAllocator::endBatch() {
+		s_batching = false;
+		for (PoolAllocator* pool : s_batch_pools) {
+			pool->m_pending_tail->next = pool->m_free;
+			pool->m_free = pool->m_pending;
+			pool->m_pending = pool->m_pending_tail = nullptr;
+		}
+		s_batch_pools.clear();
+	}
+
+}
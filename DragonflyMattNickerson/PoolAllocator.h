@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+
+namespace df {
+
+
+	// Fixed-size block allocator. Memory comes from slabs of many blocks
+	// that are kept for the life of the program, so once a pool has grown
+	// to a scene's peak population, allocate/deallocate never touch the
+	// heap. Not thread-safe: allocate and free on the main thread (parallel
+	// step handlers already defer spawns and deletes there).
+	//
+	// Between beginBatch() and endBatch() freed blocks are parked and only
+	// returned to the free list at endBatch(), in one splice per pool.
+	// WorldManager wraps its deferred deletion in a batch, so memory freed
+	// during a frame's deletions is not handed out again until they finish.
+	class PoolAllocator {
+	private:
+		struct FreeBlock { FreeBlock* next; };
+
+		std::size_t m_block_size;
+		int m_blocks_per_slab;
+		std::vector<void*> m_slabs;
+		FreeBlock* m_free;          // Ready to hand out.
+		FreeBlock* m_pending;       // Freed during the current batch.
+		FreeBlock* m_pending_tail;
+		int m_live;                 // Blocks handed out and not yet freed.
+
+		static bool s_batching;
+		static std::vector<PoolAllocator*> s_batch_pools; // Pools with parked blocks.
+
+		void grow();
+
+	public:
+		// Blocks of at least block_size bytes, aligned for any fundamental type.
+		explicit PoolAllocator(std::size_t block_size, int blocks_per_slab = 256);
+		~PoolAllocator();
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+		void* allocate();
+		void deallocate(void* p);
+
+		// Park frees until endBatch(), then release them all at once.
+		static void beginBatch();
+		static void endBatch();
+
+		int getLiveCount() const { return m_live; }
+		int getSlabCount() const { return static_cast<int>(m_slabs.size()); }
+		int getCapacity() const { return getSlabCount() * m_blocks_per_slab; }
+		std::size_t getBlockSize() const { return m_block_size; }
+	};
+
+
+	// Opt-in pooled allocation for an Object subclass:
+	//
+	//   class Bullet : public Object, public df::Pooled<Bullet> { ... };
+	//
+	// new Bullet / delete (through Object*) then use a slab pool private to
+	// Bullet. Subclasses of Bullet that are larger fall back to the heap
+	// unless they derive from Pooled<Subclass> themselves.
+	template <class T>
+	class Pooled {
+	public:
+		// The pool for T. Never destroyed, so Objects deleted during static
+		// destruction still have somewhere to go.
+		static PoolAllocator& pool() {
+			static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types cannot be pooled");
+			static PoolAllocator* p_pool = new PoolAllocator(sizeof(T));
+			return *p_pool;
+		}
+
+		static void* operator new(std::size_t size) {
+			if (size != sizeof(T)) return ::operator new(size);
+			return pool().allocate();
+		}
+
+		static void operator delete(void* p, std::size_t size) {
+			if (!p) return;
+			if (size != sizeof(T)) { ::operator delete(p); return; }
+			pool().deallocate(p);
+		}
+	};
+
+
+}
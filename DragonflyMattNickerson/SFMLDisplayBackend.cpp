@@ -0,0 +1,176 @@
+// Built only when SFML is available (see DF_NO_SFML).
+#ifndef DF_NO_SFML
+#include "SFMLDisplayBackend.h"
+#include "LogManager.h"
+#include "Color.h"
+
+static const char* WINDOW_TITLE_DEFAULT = "Dragonfly";
+static const char* FONT_FILE_DEFAULT = "df-font.ttf";
+
+// Convert df::Color to sf::Color.
+static sf::Color toSF(df::Color c) {
+    switch (c) {
+    case df::BLACK:   return sf::Color::Black;
+    case df::RED:     return sf::Color::Red;
+    case df::GREEN:   return sf::Color::Green;
+    case df::YELLOW:  return sf::Color::Yellow;
+    case df::BLUE:    return sf::Color::Blue;
+    case df::MAGENTA: return sf::Color::Magenta;
+    case df::CYAN:    return sf::Color::Cyan;
+    case df::WHITE:   return sf::Color::White;
+    default:          return sf::Color::White;
+    }
+}
+
+int SFMLDisplayBackend::open(int cols, int rows, int pixels_w, int pixels_h) {
+    if (m_p_window) return 0;
+
+    // Create window
+    m_pixels_w = pixels_w;
+    m_pixels_h = pixels_h;
+    const sf::Vector2u size(
+        static_cast<unsigned>(m_pixels_w),
+        static_cast<unsigned>(m_pixels_h));
+
+    const sf::VideoMode mode(size);
+
+    m_p_window = new sf::RenderWindow(
+        mode,
+        WINDOW_TITLE_DEFAULT,
+        WINDOW_STYLE_DEFAULT);
+
+    if (!m_p_window || !m_p_window->isOpen()) {
+        df::LogManager::getInstance().writeLog(df::LOG_ERROR, df::LOG_DISPLAY, "DisplayManager: window creation failed\n");
+        return -1;
+    }
+
+    // Load font
+    if (!m_font.openFromFile(FONT_FILE_DEFAULT)) {
+        df::LogManager::getInstance().writeLog(df::LOG_ERROR, df::LOG_DISPLAY, "DisplayManager: failed to open font '%s'\n", FONT_FILE_DEFAULT);
+        delete m_p_window;
+        m_p_window = nullptr;
+        return -1;
+    }
+
+    // Size cells and rasterize the glyph atlas to match the grid
+    m_char_size = 0;
+    layout(cols, rows);
+
+    m_p_window->clear(WINDOW_BACKGROUND_COLOR_DEFAULT);
+    return 0;
+}
+
+void SFMLDisplayBackend::close() {
+    if (m_p_window) {
+        m_p_window->close();
+        delete m_p_window;
+        m_p_window = nullptr;
+    }
+}
+
+int SFMLDisplayBackend::resize(int cols, int rows, int pixels_w, int pixels_h) {
+    if (!m_p_window) return -1;
+
+    if (pixels_w != m_pixels_w || pixels_h != m_pixels_h) {
+        m_pixels_w = pixels_w;
+        m_pixels_h = pixels_h;
+        const sf::Vector2u size(
+            static_cast<unsigned>(m_pixels_w),
+            static_cast<unsigned>(m_pixels_h));
+
+        const sf::VideoMode mode(size); // or (size, 32)
+
+        m_p_window->create(mode, WINDOW_TITLE_DEFAULT, WINDOW_STYLE_DEFAULT);
+    }
+    layout(cols, rows);
+    return 0;
+}
+
+// Derive cell sizes (monospace assumed), size the per-cell vertices, and
+// rasterize printable ASCII at a matching size. Later glyph lookups never
+// touch the font, and the atlas page is stable.
+void SFMLDisplayBackend::layout(int cols, int rows) {
+    m_cols = cols;
+    m_cell_w = static_cast<float>(m_pixels_w) / cols;
+    m_cell_h = static_cast<float>(m_pixels_h) / rows;
+
+    m_vertices.clear();
+    m_vertices.resize(static_cast<std::size_t>(cols) * rows * 6);
+
+    const unsigned int size = static_cast<unsigned int>(m_cell_h);
+    if (size != m_char_size) {
+        m_char_size = size;
+        for (int c = GLYPH_FIRST; c <= GLYPH_LAST; c++)
+            m_glyphs[c - GLYPH_FIRST] = m_font.getGlyph(static_cast<std::uint32_t>(c), m_char_size, false);
+    }
+    m_repaint = true;
+}
+
+// Cached glyph for printable ASCII, otherwise ask the font (which
+// rasterizes into the same atlas page on first use).
+const sf::Glyph& SFMLDisplayBackend::glyphFor(char ch) const {
+    const int c = static_cast<unsigned char>(ch);
+    if (c >= GLYPH_FIRST && c <= GLYPH_LAST)
+        return m_glyphs[c - GLYPH_FIRST];
+    return m_font.getGlyph(static_cast<std::uint32_t>(c), m_char_size, false);
+}
+
+// Rebuild the two triangles for cell i from the presented frame. Blank
+// cells collapse to a degenerate quad that rasterizes nothing.
+void SFMLDisplayBackend::writeCell(const CellBuffer& cells, int i) {
+    sf::Vertex* v = &m_vertices[static_cast<std::size_t>(i) * 6];
+    const CellBuffer::Cell cell = cells.getFront(i);
+    const sf::Glyph& g = glyphFor(CellBuffer::glyphOf(cell));
+    if (cell == CellBuffer::BLANK || g.textureRect.size.x == 0 || g.textureRect.size.y == 0) {
+        for (int k = 0; k < 6; k++) v[k] = sf::Vertex{};
+        return;
+    }
+
+    // Same placement sf::Text used: baseline one character size below the
+    // cell top, nudged down a tenth of a cell.
+    const float x = static_cast<float>(i % m_cols) * m_cell_w;
+    const float y = static_cast<float>(i / m_cols) * m_cell_h + (m_cell_h * 0.1f) + static_cast<float>(m_char_size);
+
+    const float left = x + g.bounds.position.x;
+    const float top = y + g.bounds.position.y;
+    const float right = left + g.bounds.size.x;
+    const float bottom = top + g.bounds.size.y;
+
+    const float u0 = static_cast<float>(g.textureRect.position.x);
+    const float v0 = static_cast<float>(g.textureRect.position.y);
+    const float u1 = u0 + static_cast<float>(g.textureRect.size.x);
+    const float v1 = v0 + static_cast<float>(g.textureRect.size.y);
+
+    const sf::Color c = toSF(CellBuffer::colorOf(cell));
+    v[0] = { {left,  top},    c, {u0, v0} };
+    v[1] = { {right, top},    c, {u1, v0} };
+    v[2] = { {left,  bottom}, c, {u0, v1} };
+    v[3] = v[2];
+    v[4] = v[1];
+    v[5] = { {right, bottom}, c, {u1, v1} };
+}
+
+// Re-emit quads only for changed cells, then draw the whole grid in one
+// call. A window backbuffer cannot be patched in place, so the draw
+// itself happens every frame.
+int SFMLDisplayBackend::present(const CellBuffer& cells) {
+    if (!m_p_window) return -1;
+
+    if (m_repaint) {
+        const int n = cells.getCols() * cells.getRows();
+        for (int i = 0; i < n; i++)
+            writeCell(cells, i);
+        m_repaint = false;
+    }
+    else {
+        for (int i : cells.getChanged())
+            writeCell(cells, i);
+    }
+
+    m_p_window->clear(WINDOW_BACKGROUND_COLOR_DEFAULT);
+    m_p_window->draw(m_vertices, sf::RenderStates(&m_font.getTexture(m_char_size)));
+    m_p_window->display();
+    return 0;
+}
+
+#endif // DF_NO_SFML
@@ -0,0 +1,50 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "DisplayBackend.h"
+
+// Defaults for SFML window.
+constexpr auto WINDOW_STYLE_DEFAULT = sf::Style::Titlebar;
+const sf::Color WINDOW_BACKGROUND_COLOR_DEFAULT = sf::Color::Black;
+
+// Renders the character grid into an SFML window from a glyph atlas.
+class SFMLDisplayBackend : public DisplayBackend {
+private:
+    sf::Font          m_font;
+    sf::RenderWindow* m_p_window{ nullptr };
+
+    int   m_pixels_w{ 0 };
+    int   m_pixels_h{ 0 };
+    int   m_cols{ 0 };
+    float m_cell_w{ 0.f };
+    float m_cell_h{ 0.f };
+
+    // Glyph atlas: printable ASCII is rasterized once into the font's
+    // texture page for m_char_size, and the metrics cached here.
+    static constexpr int GLYPH_FIRST = 32;
+    static constexpr int GLYPH_LAST = 126;
+    unsigned int m_char_size{ 0 };
+    sf::Glyph    m_glyphs[GLYPH_LAST - GLYPH_FIRST + 1];
+    bool         m_repaint{ true }; // Glyphs changed; rebuild every cell.
+
+    // Two triangles per grid cell, rewritten only for cells that changed
+    // and drawn in one call per frame.
+    sf::VertexArray m_vertices{ sf::PrimitiveType::Triangles };
+
+    // helpers
+    void             layout(int cols, int rows);
+    const sf::Glyph& glyphFor(char ch) const;
+    void             writeCell(const CellBuffer& cells, int i);
+
+public:
+    SFMLDisplayBackend() = default;
+    SFMLDisplayBackend(const SFMLDisplayBackend&) = delete;
+    SFMLDisplayBackend& operator=(const SFMLDisplayBackend&) = delete;
+    ~SFMLDisplayBackend() override { close(); }
+
+    int  open(int cols, int rows, int pixels_w, int pixels_h) override;
+    void close() override;
+    int  resize(int cols, int rows, int pixels_w, int pixels_h) override;
+    int  present(const CellBuffer& cells) override;
+
+    sf::RenderWindow* getWindow() const { return m_p_window; }
+};
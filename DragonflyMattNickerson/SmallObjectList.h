@@ -0,0 +1,52 @@
+#pragma once
+#include <cassert>
+#include <vector>
+
+class Object;
+
+
+// Result container for world queries. Holds up to N Object pointers
+// inline and only touches the heap if a query returns more than that.
+template <int N = 16>
+class SmallObjectList {
+private:
+	Object* m_inline[N]{}; // Inline storage used until it overflows.
+	std::vector<Object*> m_heap; // All entries once inline storage overflows.
+	int m_count{ 0 }; // Count of objects in list.
+
+	Object* const* data() const { return m_heap.empty() ? m_inline : m_heap.data(); }
+
+public:
+	// Insert object pointer in list. Return 0 if ok, else -1.
+	int insert(Object* p_o) {
+		if (p_o == nullptr) return -1;
+		if (m_heap.empty()) {
+			if (m_count < N) {
+				m_inline[m_count++] = p_o;
+				return 0;
+			}
+			m_heap.assign(m_inline, m_inline + N); // spill
+		}
+		m_heap.push_back(p_o);
+		++m_count;
+		return 0;
+	}
+
+	// Clear list (setting count to 0). Keeps any heap capacity.
+	void clear() {
+		m_heap.clear();
+		m_count = 0;
+	}
+
+	// Return count of number of objects in list.
+	int getCount() const { return m_count; }
+
+	// Unchecked index (asserts in debug). Returns pointer to Object.
+	Object* operator[](int i) const {
+		assert(i >= 0 && i < m_count);
+		return data()[i];
+	}
+
+	Object* const* begin() const { return data(); }
+	Object* const* end() const { return data() + m_count; }
+};
@@ -0,0 +1,50 @@
+#include "SpatialGrid.h"
+#include "Object.h"
+#include <algorithm>
+
+// Pack truncated (x,y) cell coordinates into a single key.
+std::uint64_t SpatialGrid::cellKey(const Vector& pos) {
+	const std::uint32_t x = static_cast<std::uint32_t>(static_cast<int>(pos.getX()));
+	const std::uint32_t y = static_cast<std::uint32_t>(static_cast<int>(pos.getY()));
+	return (static_cast<std::uint64_t>(x) << 32) | y;
+}
+
+// Add Object to the cell containing pos.
+void SpatialGrid::insert(Object* p_o, const Vector& pos) {
+	if (!p_o) return;
+	std::vector<Object*>& bucket = m_cells[cellKey(pos)];
+	bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), p_o,
+		[](const Object* a, const Object* b) { return a->getId() < b->getId(); }), p_o);
+}
+
+// Remove Object from the cell containing pos. Return 0 if found, else -1.
+int SpatialGrid::remove(Object* p_o, const Vector& pos) {
+	auto it = m_cells.find(cellKey(pos));
+	if (it == m_cells.end()) return -1;
+
+	std::vector<Object*>& bucket = it->second;
+	for (std::size_t i = 0; i < bucket.size(); ++i) {
+		if (bucket[i] == p_o) {
+			bucket.erase(bucket.begin() + static_cast<std::ptrdiff_t>(i)); // keeps id order; empty cells stay allocated
+			return 0;
+		}
+	}
+	return -1;
+}
+
+// Move Object between cells (no-op if both positions share a cell).
+void SpatialGrid::move(Object* p_o, const Vector& from, const Vector& to) {
+	if (cellKey(from) == cellKey(to)) return;
+	if (remove(p_o, from) == 0) insert(p_o, to); // only track Objects already in the grid
+}
+
+// Return Objects in the cell containing pos (nullptr if cell is empty).
+const std::vector<Object*>* SpatialGrid::query(const Vector& pos) const {
+	auto it = m_cells.find(cellKey(pos));
+	return (it == m_cells.end()) ? nullptr : &it->second;
+}
+
+// Remove all Objects from all cells.
+void SpatialGrid::clear() {
+	m_cells.clear();
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Vector.h"
+
+class Object;
+
+// Uniform spatial hash over the integer grid cells the engine truncates
+// world positions to. Each cell holds the Objects currently located in it,
+// in id order, so queries list them in a deterministic order.
+class SpatialGrid {
+private:
+	std::unordered_map<std::uint64_t, std::vector<Object*>> m_cells;
+
+	// Pack truncated (x,y) cell coordinates into a single key.
+	static std::uint64_t cellKey(const Vector& pos);
+
+public:
+	// Add Object to the cell containing pos.
+	void insert(Object* p_o, const Vector& pos);
+
+	// Remove Object from the cell containing pos. Return 0 if found, else -1.
+	int remove(Object* p_o, const Vector& pos);
+
+	// Move Object between cells (no-op if both positions share a cell).
+	void move(Object* p_o, const Vector& from, const Vector& to);
+
+	// Return Objects in the cell containing pos (nullptr if cell is empty).
+	const std::vector<Object*>* query(const Vector& pos) const;
+
+	// Remove all Objects from all cells.
+	void clear();
+
+	// Make room for count occupied cells without rehashing.
+	void reserve(std::size_t count) { m_cells.reserve(count); }
+};
@@ -0,0 +1,105 @@
+#include "TerminalDisplayBackend.h"
+#include "Color.h"
+
+#include <cerrno>
+#include <cstdio>
+
+#if defined(_WIN32)
+#include <io.h>
+#define DF_WRITE(fd, buf, n) _write((fd), (buf), static_cast<unsigned int>(n))
+#else
+#include <unistd.h>
+#define DF_WRITE(fd, buf, n) ::write((fd), (buf), (n))
+#endif
+
+// ANSI sequences: hide/show cursor, clear screen, reset attributes.
+static const char* const ANSI_HIDE_CURSOR = "\x1b[?25l";
+static const char* const ANSI_SHOW_CURSOR = "\x1b[?25h";
+static const char* const ANSI_CLEAR = "\x1b[2J";
+static const char* const ANSI_RESET = "\x1b[0m";
+
+int TerminalDisplayBackend::open(int cols, int rows, int, int) {
+    if (m_open) return 0;
+    m_cols = cols;
+    m_rows = rows;
+    m_cursor = -1;
+    m_color = -1;
+    m_out.reserve(static_cast<std::size_t>(cols) * rows * 4);
+
+    m_out.assign(ANSI_HIDE_CURSOR);
+    m_out += ANSI_CLEAR;
+    if (flush() != 0) return -1;
+    m_open = true;
+    return 0;
+}
+
+void TerminalDisplayBackend::close() {
+    if (!m_open) return;
+    m_open = false;
+
+    // Leave the cursor below the grid with normal attributes.
+    char buf[32];
+    std::snprintf(buf, sizeof buf, "\x1b[%d;1H", m_rows + 1);
+    m_out.assign(ANSI_RESET);
+    m_out += buf;
+    m_out += ANSI_SHOW_CURSOR;
+    (void)flush();
+}
+
+int TerminalDisplayBackend::resize(int cols, int rows, int, int) {
+    if (!m_open) return -1;
+    m_cols = cols;
+    m_rows = rows;
+    m_cursor = -1;
+    m_out.assign(ANSI_CLEAR);
+    return flush();
+}
+
+int TerminalDisplayBackend::present(const CellBuffer& cells) {
+    if (!m_open) return -1;
+    const std::vector<int>& changed = cells.getChanged();
+    if (changed.empty()) return 0;
+
+    m_out.clear();
+    char buf[32];
+    for (int i : changed) {
+        if (i != m_cursor) {
+            std::snprintf(buf, sizeof buf, "\x1b[%d;%dH", i / m_cols + 1, i % m_cols + 1);
+            m_out += buf;
+        }
+
+        const CellBuffer::Cell cell = cells.getFront(i);
+        if (cell != CellBuffer::BLANK) {
+            // df::Color values follow the ANSI color order (30 + color).
+            const int color = CellBuffer::colorOf(cell);
+            if (color != m_color) {
+                std::snprintf(buf, sizeof buf, "\x1b[%dm", 30 + color);
+                m_out += buf;
+                m_color = color;
+            }
+        }
+        m_out += CellBuffer::glyphOf(cell);
+
+        // Writing the last column leaves the cursor in a pending-wrap
+        // state that terminals treat differently, so forget it.
+        m_cursor = (i % m_cols == m_cols - 1) ? -1 : i + 1;
+    }
+    return flush();
+}
+
+// One write() per frame; loop only if the kernel takes a partial write.
+int TerminalDisplayBackend::flush() {
+    const char* p = m_out.data();
+    std::size_t left = m_out.size();
+    while (left > 0) {
+        const auto n = DF_WRITE(m_fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    m_out.clear();
+    return 0;
+}
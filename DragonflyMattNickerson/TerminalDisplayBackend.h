@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include "DisplayBackend.h"
+
+// Renders the character grid to a terminal (or pipe) with ANSI escapes.
+// Only changed cells are written. The cursor is moved only when the next
+// changed cell does not directly follow the last one written, and the
+// color is set only when it differs. Each frame is one write() call.
+class TerminalDisplayBackend : public DisplayBackend {
+private:
+    int  m_fd;
+    bool m_open{ false };
+    int  m_cols{ 0 };
+    int  m_rows{ 0 };
+    int  m_cursor{ -1 }; // Cell index the terminal cursor is on, -1 if unknown.
+    int  m_color{ -1 };  // Foreground color last set, -1 if unknown.
+    std::string m_out;   // Frame being assembled.
+
+    // Write m_out fully to m_fd. Return 0 ok else -1.
+    int flush();
+
+public:
+    // Write frames to the given file descriptor (stdout by default).
+    explicit TerminalDisplayBackend(int fd = 1) : m_fd(fd) {}
+    TerminalDisplayBackend(const TerminalDisplayBackend&) = delete;
+    TerminalDisplayBackend& operator=(const TerminalDisplayBackend&) = delete;
+    ~TerminalDisplayBackend() override { close(); }
+
+    int  open(int cols, int rows, int pixels_w, int pixels_h) override;
+    void close() override;
+    int  resize(int cols, int rows, int pixels_w, int pixels_h) override;
+    int  present(const CellBuffer& cells) override;
+};
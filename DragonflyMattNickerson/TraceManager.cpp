@@ -0,0 +1,120 @@
+#include "TraceManager.h"
+#include "LogManager.h"
+
+#include <cstdio>
+
+
+namespace df {
+
+	std::atomic<bool> TraceManager::s_recording{ false };
+
+	namespace {
+		thread_local void* t_buffer = nullptr; // This thread's ThreadBuffer.
+
+		// Write s as a JSON string body (quotes and backslashes escaped).
+		void writeEscaped(FILE* f, const char* s) {
+			for (; *s; ++s) {
+				if (*s == '"' || *s == '\\') fputc('\\', f);
+				if (static_cast<unsigned char>(*s) >= 0x20) fputc(*s, f);
+			}
+		}
+	}
+
+	TraceManager::TraceManager() : m_epoch(std::chrono::steady_clock::now()) {
+		setType("TraceManager");
+	}
+
+	TraceManager& TraceManager::getInstance() {
+		static TraceManager inst;
+		return inst;
+	}
+
+	int TraceManager::startUp() {
+		if (isStarted()) return 0;
+		{
+			std::lock_guard<std::mutex> g(m_buffers_lock);
+			for (auto& b : m_buffers) { b->spans.clear(); b->dropped = 0; }
+		}
+		threadBuffer(); // Starting thread gets the first id if it has none.
+		m_epoch = std::chrono::steady_clock::now();
+		s_recording.store(true);
+		Manager::startUp();
+		LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE, "TraceManager started\n");
+		return 0;
+	}
+
+	void TraceManager::shutDown() {
+		if (!isStarted()) return;
+		s_recording.store(false);
+		if (writeTrace(TRACEFILE_NAME) == 0)
+			LogManager::getInstance().writeLog(LOG_INFO, LOG_ENGINE,
+				"TraceManager wrote %d spans to %s\n", getSpanCount(), TRACEFILE_NAME.c_str());
+		Manager::shutDown();
+	}
+
+	// Buffers are created once per thread and never freed, so the
+	// thread-local pointer stays valid across start/stop cycles.
+	TraceManager::ThreadBuffer& TraceManager::threadBuffer() {
+		if (!t_buffer) {
+			std::lock_guard<std::mutex> g(m_buffers_lock);
+			auto p = std::make_unique<ThreadBuffer>();
+			p->tid = static_cast<int>(m_buffers.size()) + 1;
+			p->spans.reserve(1024);
+			t_buffer = p.get();
+			m_buffers.push_back(std::move(p));
+		}
+		return *static_cast<ThreadBuffer*>(t_buffer);
+	}
+
+	void TraceManager::record(const char* name, const char* category,
+		std::chrono::steady_clock::time_point start,
+		std::chrono::steady_clock::time_point end) {
+		ThreadBuffer& b = threadBuffer();
+		if (static_cast<int>(b.spans.size()) >= TRACE_SPANS_PER_THREAD) {
+			++b.dropped;
+			return;
+		}
+		using std::chrono::duration_cast;
+		using std::chrono::nanoseconds;
+		b.spans.push_back({ name, category,
+			duration_cast<nanoseconds>(start - m_epoch).count(),
+			duration_cast<nanoseconds>(end - start).count() });
+	}
+
+	// Complete ("X") events in microseconds, plus a thread_name record per thread.
+	int TraceManager::writeTrace(const std::string& filename) {
+		FILE* f = nullptr;
+		if (fopen_s(&f, filename.c_str(), "w") != 0 || !f) return -1;
+
+		std::lock_guard<std::mutex> g(m_buffers_lock);
+		fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", f);
+		bool first = true;
+		for (const auto& b : m_buffers) {
+			fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+				first ? "" : ",", b->tid, b->tid);
+			first = false;
+			for (const Span& s : b->spans) {
+				fputs(",\n{\"name\":\"", f);
+				writeEscaped(f, s.name);
+				fputs("\",\"cat\":\"", f);
+				writeEscaped(f, s.category);
+				fprintf(f, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+					b->tid, s.start_ns / 1000.0, s.dur_ns / 1000.0);
+			}
+			if (b->dropped > 0)
+				LogManager::getInstance().writeLog(LOG_WARNING, LOG_ENGINE,
+					"TraceManager: thread %d dropped %lld spans\n", b->tid, b->dropped);
+		}
+		fputs("\n]}\n", f);
+		fclose(f);
+		return 0;
+	}
+
+	int TraceManager::getSpanCount() {
+		std::lock_guard<std::mutex> g(m_buffers_lock);
+		int n = 0;
+		for (const auto& b : m_buffers) n += static_cast<int>(b->spans.size());
+		return n;
+	}
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Manager.h"
+
+
+namespace df {
+
+
+	// Spans kept per thread; later spans on a full buffer are dropped.
+	const int TRACE_SPANS_PER_THREAD = 1 << 18;
+
+	// Default file written at shut down.
+	const std::string TRACEFILE_NAME = "dragonfly.trace.json";
+
+
+	// Records begin/end spans into per-thread buffers and exports them as
+	// Chrome trace-event JSON (chrome://tracing, Perfetto). Recording is on
+	// between startUp() and shutDown(); shutDown() writes TRACEFILE_NAME.
+	// While stopped, a TraceScope costs one relaxed atomic load.
+	class TraceManager : public Manager {
+	private:
+		TraceManager();
+		TraceManager(const TraceManager&) = delete;
+		TraceManager& operator=(const TraceManager&) = delete;
+
+		struct Span {
+			const char* name;     // Static storage (string literal, Event::TYPE).
+			const char* category; // Static storage.
+			long long start_ns;   // Since m_epoch.
+			long long dur_ns;
+		};
+
+		struct ThreadBuffer {
+			int tid;
+			std::vector<Span> spans;
+			long long dropped{ 0 };
+		};
+
+		static std::atomic<bool> s_recording;
+		std::chrono::steady_clock::time_point m_epoch;
+		std::mutex m_buffers_lock; // Guards m_buffers (taken once per thread).
+		std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+		ThreadBuffer& threadBuffer();
+
+	public:
+		// Get the one and only instance of the TraceManager.
+		static TraceManager& getInstance();
+
+
+		// Clear old spans and start recording.
+		int startUp() override;
+
+
+		// Stop recording and write the trace to TRACEFILE_NAME.
+		void shutDown() override;
+
+
+		// True while spans are being recorded.
+		static bool isRecording() { return s_recording.load(std::memory_order_relaxed); }
+
+
+		// Record a finished span on the calling thread.
+		void record(const char* name, const char* category,
+			std::chrono::steady_clock::time_point start,
+			std::chrono::steady_clock::time_point end);
+
+
+		// Write all recorded spans as Chrome trace JSON. Call between frames
+		// (not while a parallel job is running). Return 0 ok else -1.
+		int writeTrace(const std::string& filename);
+
+
+		// Number of spans recorded across all threads.
+		int getSpanCount();
+	};
+
+
+	// Times its own lifetime as a span. name and category must outlive
+	// the trace (string literals or Event type names).
+	class TraceScope {
+	private:
+		const char* m_name;
+		const char* m_category;
+		std::chrono::steady_clock::time_point m_start;
+
+	public:
+		explicit TraceScope(const char* name, const char* category = "engine")
+			: m_name(nullptr), m_category(category) {
+			if (!TraceManager::isRecording()) return;
+			m_name = name;
+			m_start = std::chrono::steady_clock::now();
+		}
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+
+		~TraceScope() {
+			if (m_name)
+				TraceManager::getInstance().record(m_name, m_category, m_start,
+					std::chrono::steady_clock::now());
+		}
+	};
+
+
+}
@@ -0,0 +1,132 @@
+#include "TransformStore.h"
+#include "Object.h"
+#include "JobManager.h"
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DF_TRANSFORM_SSE2 1
+#endif
+
+namespace {
+	// dst[i] = a[i] + b[i] for i in [0, n).
+	void addArrays(float* dst, const float* a, const float* b, std::size_t n) {
+		std::size_t i = 0;
+#if defined(__AVX__)
+		for (; i + 8 <= n; i += 8)
+			_mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+#elif defined(DF_TRANSFORM_SSE2)
+		for (; i + 4 <= n; i += 4)
+			_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+#endif
+		for (; i < n; ++i) dst[i] = a[i] + b[i];
+	}
+}
+
+// Get the one and only instance of the TransformStore.
+TransformStore& TransformStore::getInstance() {
+	static TransformStore inst;
+	return inst;
+}
+
+// Allocate entry for Object (zeroed). Return its index.
+int TransformStore::add(Object* p_o) {
+	m_px.push_back(0.0f); m_py.push_back(0.0f);
+	m_vx.push_back(0.0f); m_vy.push_back(0.0f);
+	m_dest_x.push_back(0.0f); m_dest_y.push_back(0.0f);
+	m_dirty.push_back(1);
+	m_solidness.push_back(0);
+	m_altitude.push_back(0);
+	m_owner.push_back(p_o);
+	m_moving_slot.push_back(-1);
+	return static_cast<int>(m_owner.size() - 1);
+}
+
+// Make room for count entries in total.
+void TransformStore::reserve(int count) {
+	if (count <= 0) return;
+	const std::size_t n = static_cast<std::size_t>(count);
+	m_px.reserve(n); m_py.reserve(n);
+	m_vx.reserve(n); m_vy.reserve(n);
+	m_dest_x.reserve(n); m_dest_y.reserve(n);
+	m_dirty.reserve(n);
+	m_solidness.reserve(n);
+	m_altitude.reserve(n);
+	m_owner.reserve(n);
+	m_moving_slot.reserve(n);
+}
+
+// Add entry k to or drop it from the moving set. The set is shared, so
+// inside a parallel job the change waits until the batch ends (and then
+// follows whatever velocity the Object has by then).
+void TransformStore::changeMoving(std::size_t k) {
+	if (df::JobManager::inParallelJob()) {
+		Object* p_o = m_owner[k];
+		df::JobManager::defer([this, p_o] { updateMoving(static_cast<std::size_t>(p_o->m_transform)); });
+		return;
+	}
+	if (m_moving_slot[k] >= 0) {
+		dropMoving(k);
+		return;
+	}
+	m_moving_slot[k] = static_cast<int>(m_moving.size());
+	m_moving.push_back(static_cast<int>(k));
+}
+
+// Drop entry k from the moving set (swap-and-pop).
+void TransformStore::dropMoving(std::size_t k) {
+	const int slot = m_moving_slot[k];
+	const int last = m_moving.back();
+	m_moving[static_cast<std::size_t>(slot)] = last;
+	m_moving_slot[static_cast<std::size_t>(last)] = slot;
+	m_moving.pop_back();
+	m_moving_slot[k] = -1;
+}
+
+// Release entry i. The last entry moves into i and its owner is updated.
+void TransformStore::remove(int i) {
+	const std::size_t k = static_cast<std::size_t>(i);
+	const std::size_t last = m_owner.size() - 1;
+	if (m_moving_slot[k] >= 0) dropMoving(k);
+	if (k != last) {
+		m_px[k] = m_px[last]; m_py[k] = m_py[last];
+		m_vx[k] = m_vx[last]; m_vy[k] = m_vy[last];
+		m_dest_x[k] = m_dest_x[last]; m_dest_y[k] = m_dest_y[last];
+		m_dirty[k] = m_dirty[last];
+		m_solidness[k] = m_solidness[last];
+		m_altitude[k] = m_altitude[last];
+		m_owner[k] = m_owner[last];
+		m_owner[k]->m_transform = i;
+		m_moving_slot[k] = m_moving_slot[last];
+		if (m_moving_slot[k] >= 0) m_moving[static_cast<std::size_t>(m_moving_slot[k])] = i;
+	}
+	m_px.pop_back(); m_py.pop_back();
+	m_vx.pop_back(); m_vy.pop_back();
+	m_dest_x.pop_back(); m_dest_y.pop_back();
+	m_dirty.pop_back();
+	m_solidness.pop_back();
+	m_altitude.pop_back();
+	m_owner.pop_back();
+	m_moving_slot.pop_back();
+}
+
+// Compute destination (position + velocity) of every moving entry.
+// Entries at rest keep their dirty flag, so getDestination() stays right.
+void TransformStore::integrate() {
+	const std::size_t n = m_owner.size();
+	if (n == 0) return;
+	if (m_moving.size() * 2 >= n) {
+		addArrays(m_dest_x.data(), m_px.data(), m_vx.data(), n);
+		addArrays(m_dest_y.data(), m_py.data(), m_vy.data(), n);
+		std::memset(m_dirty.data(), 0, n);
+		return;
+	}
+	for (int i : m_moving) {
+		const std::size_t k = static_cast<std::size_t>(i);
+		m_dest_x[k] = m_px[k] + m_vx[k];
+		m_dest_y[k] = m_py[k] + m_vy[k];
+		m_dirty[k] = 0;
+	}
+}
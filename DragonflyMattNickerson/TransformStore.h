@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Vector.h"
+
+class Object;
+
+
+// Engine-owned structure-of-arrays storage for the per-Object data the
+// movement phase touches: position, velocity, solidness and altitude.
+// Every live Object owns one index; Object accessors forward here.
+// Removal swaps the last entry into the hole, so indices are not stable.
+// Entries with non-zero velocity are also kept in a moving set, updated
+// as velocities change to and from zero, so movement costs nothing for
+// Objects at rest.
+class TransformStore {
+private:
+	TransformStore() = default;
+	TransformStore(const TransformStore&) = delete;
+	TransformStore& operator=(const TransformStore&) = delete;
+
+	std::vector<float> m_px, m_py; // Position.
+	std::vector<float> m_vx, m_vy; // Velocity.
+	std::vector<float> m_dest_x, m_dest_y; // Position + velocity as of integrate().
+	std::vector<std::uint8_t> m_dirty; // Position/velocity changed since integrate().
+	std::vector<std::uint8_t> m_solidness; // Solidness (stored as its underlying value).
+	std::vector<int> m_altitude; // Altitude.
+	std::vector<Object*> m_owner; // Object owning each index.
+	std::vector<int> m_moving; // Indices of entries with non-zero velocity.
+	std::vector<int> m_moving_slot; // Position of each entry in m_moving (-1 if at rest).
+
+	// Add entry k to or drop it from the moving set to match its velocity.
+	void updateMoving(std::size_t k) {
+		const bool moving = m_vx[k] != 0.0f || m_vy[k] != 0.0f;
+		if (moving != (m_moving_slot[k] >= 0)) changeMoving(k);
+	}
+	void changeMoving(std::size_t k);
+	void dropMoving(std::size_t k);
+
+public:
+	// Get the one and only instance of the TransformStore.
+	static TransformStore& getInstance();
+
+
+	// Allocate entry for Object (zeroed). Return its index.
+	int add(Object* p_o);
+
+
+	// Release entry i. The last entry moves into i and its owner is updated.
+	void remove(int i);
+
+
+	// Make room for count entries in total (bulk creation).
+	void reserve(int count);
+
+
+	// Return count of entries.
+	int getCount() const { return static_cast<int>(m_owner.size()); }
+
+
+	// Return Object owning entry i.
+	Object* getOwner(int i) const { return m_owner[static_cast<std::size_t>(i)]; }
+
+
+	// Compute destination (position + velocity) of every moving entry:
+	// one vectorized pass over all entries (AVX or SSE2 where available)
+	// when most are moving, else only the moving set.
+	void integrate();
+
+
+	// Moving set: count, and index of the j-th moving entry (any order).
+	int getMovingCount() const { return static_cast<int>(m_moving.size()); }
+	int getMoving(int j) const { return m_moving[static_cast<std::size_t>(j)]; }
+
+
+	// True if entry i has non-zero velocity.
+	bool isMoving(int i) const {
+		const std::size_t k = static_cast<std::size_t>(i);
+		return m_vx[k] != 0.0f || m_vy[k] != 0.0f;
+	}
+
+
+	// Destination of entry i (recomputed if it changed since integrate()).
+	Vector getDestination(int i) const {
+		const std::size_t k = static_cast<std::size_t>(i);
+		if (m_dirty[k]) return Vector(m_px[k] + m_vx[k], m_py[k] + m_vy[k]);
+		return Vector(m_dest_x[k], m_dest_y[k]);
+	}
+
+
+	// Get/set position.
+	Vector getPosition(int i) const {
+		const std::size_t k = static_cast<std::size_t>(i);
+		return Vector(m_px[k], m_py[k]);
+	}
+	void setPosition(int i, const Vector& pos) {
+		const std::size_t k = static_cast<std::size_t>(i);
+		m_px[k] = pos.getX(); m_py[k] = pos.getY(); m_dirty[k] = 1;
+	}
+
+
+	// Get/set velocity.
+	float getVelocityX(int i) const { return m_vx[static_cast<std::size_t>(i)]; }
+	float getVelocityY(int i) const { return m_vy[static_cast<std::size_t>(i)]; }
+	void setVelocityX(int i, float vx) {
+		const std::size_t k = static_cast<std::size_t>(i);
+		m_vx[k] = vx; m_dirty[k] = 1; updateMoving(k);
+	}
+	void setVelocityY(int i, float vy) {
+		const std::size_t k = static_cast<std::size_t>(i);
+		m_vy[k] = vy; m_dirty[k] = 1; updateMoving(k);
+	}
+
+
+	// Get/set solidness.
+	std::uint8_t getSolidness(int i) const { return m_solidness[static_cast<std::size_t>(i)]; }
+	void setSolidness(int i, std::uint8_t s) { m_solidness[static_cast<std::size_t>(i)] = s; }
+
+
+	// Get/set altitude.
+	int getAltitude(int i) const { return m_altitude[static_cast<std::size_t>(i)]; }
+	void setAltitude(int i, int a) { m_altitude[static_cast<std::size_t>(i)] = a; }
+};
@@ -0,0 +1,31 @@
+#include "TypeRegistry.h"
+
+// Get the one and only instance of the TypeRegistry.
+TypeRegistry& TypeRegistry::getInstance() {
+	static TypeRegistry inst;
+	return inst;
+}
+
+// Return id for type name, registering it if new.
+int TypeRegistry::intern(const std::string& name) {
+	auto it = m_ids.find(name);
+	if (it != m_ids.end()) return it->second;
+
+	const int id = static_cast<int>(m_names.size());
+	m_names.push_back(name);
+	m_ids.emplace(name, id);
+	return id;
+}
+
+// Return id for type name, or -1 if never registered.
+int TypeRegistry::find(const std::string& name) const {
+	auto it = m_ids.find(name);
+	return (it == m_ids.end()) ? -1 : it->second;
+}
+
+// Return name for id (empty string if unknown).
+const std::string& TypeRegistry::getName(int id) const {
+	static const std::string unknown;
+	if (id < 0 || id >= getCount()) return unknown;
+	return m_names[static_cast<std::size_t>(id)];
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+
+// Interns Object type names into compact integer ids (0, 1, 2, ...).
+// Ids are stable for the life of the program, so game code can cache
+// them and compare types with a single integer compare.
+class TypeRegistry {
+private:
+	TypeRegistry() = default;
+	TypeRegistry(const TypeRegistry&) = delete;
+	TypeRegistry& operator=(const TypeRegistry&) = delete;
+
+	std::unordered_map<std::string, int> m_ids; // Name -> id.
+	std::deque<std::string> m_names; // Id -> name (deque keeps references stable).
+
+public:
+	// Get the one and only instance of the TypeRegistry.
+	static TypeRegistry& getInstance();
+
+
+	// Return id for type name, registering it if new.
+	int intern(const std::string& name);
+
+
+	// Return id for type name, or -1 if never registered.
+	int find(const std::string& name) const;
+
+
+	// Return name for id (empty string if unknown).
+	const std::string& getName(int id) const;
+
+
+	// Return count of registered types.
+	int getCount() const { return static_cast<int>(m_names.size()); }
+};
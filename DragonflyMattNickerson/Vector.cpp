@@ -1,20 +1,7 @@
 #include "Vector.h"
 #include <cmath>
 
-// Constructor
-Vector::Vector(float init_x, float init_y) : m_x(init_x), m_y(init_y) {}
-Vector::Vector() : m_x(0.0f), m_y(0.0f) {}
-
-// Get/set horizontal component.
-void Vector::setX(float new_x) { m_x = new_x; }
-float Vector::getX() const { return m_x; }
-
-// Get/set vertical component.
-void Vector::setY(float new_y) { m_y = new_y; }
-float Vector::getY() const { return m_y; }
-
-// Set horizontal & vertical components.
-void Vector::setXY(float new_x, float new_y) { m_x = new_x; m_y = new_y; }
+// Constructors and get/set are inline in Vector.h.
 
 // Return magnitude of vector.
 float Vector::getMagnitude() const {
@@ -7,25 +7,25 @@ private:
 
 public:
 	// Create Vector with (x,y).
-	Vector(float init_x, float init_y);
+	Vector(float init_x, float init_y) : m_x(init_x), m_y(init_y) {}
 
 
 	// Default 2d (x,y) is (0,0).
-	Vector();
+	Vector() : m_x(0.0f), m_y(0.0f) {}
 
 
 	// Get/set horizontal component.
-	void setX(float new_x);
-	float getX() const;
+	void setX(float new_x) { m_x = new_x; }
+	float getX() const { return m_x; }
 
 
 	// Get/set vertical component.
-	void setY(float new_y);
-	float getY() const;
+	void setY(float new_y) { m_y = new_y; }
+	float getY() const { return m_y; }
 
 
 	// Set horizontal & vertical components.
-	void setXY(float new_x, float new_y);
+	void setXY(float new_x, float new_y) { m_x = new_x; m_y = new_y; }
 
 
 	// Return magnitude of vector.
@@ -42,4 +42,4 @@ public:
 
 	// Add two Vectors, return new Vector.
 	Vector operator+(const Vector& other) const;
-};
\ No newline at end of file
+};
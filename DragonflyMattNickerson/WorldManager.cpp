@@ -1,9 +1,22 @@
 #include "WorldManager.h"
 #include "LogManager.h"
 #include "Object.h"
+#include "TypeRegistry.h"
+#include "TransformStore.h"
+#include "JobManager.h"
+#include "FrameProfiler.h"
+#include "TraceManager.h"
+#include "PoolAllocator.h"
+#include "MappedFile.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include "EventOut.h"
 #include "EventCollision.h"
+#include "EventStep.h"
+#include "EventKeyboard.h"
+#include "EventMouse.h"
 #include <iostream>
 #include "Vector.h"
 #include "Manager.h"
@@ -23,26 +36,65 @@ int WorldManager::startUp() {
     if (isStarted()) return 0;
     m_updates.clear();
     m_deletions.clear();
+    m_deactivations.clear();
+    m_grid.clear();
+    m_tree.clear();
+    m_contacts.clear();
+    m_by_type.clear();
+    m_by_altitude.clear();
+    m_inactive.clear();
     df::Manager::startUp();
-    df::LogManager::getInstance().writeLog("WorldManager started\n");
+    df::LogManager::getInstance().writeLog(df::LOG_INFO, df::LOG_ENGINE, "WorldManager started\n");
     m_width = 80;
     m_height = 24;
+    m_view = Box(Vector(0, 0), 80, 24);
     return 0;
 }
 // Shutdown game world (delete all game world Objects).
 void WorldManager::shutDown() {
-    df::LogManager::getInstance().writeLog("WorldManager shutting down\n");
+    df::LogManager::getInstance().writeLog(df::LOG_INFO, df::LOG_ENGINE, "WorldManager shutting down\n");
     // Delete remaining objects to avoid leaks.
-    for (int i = 0; i < m_updates.getCount(); ++i) {
-        delete m_updates[i];
+    // Each destructor removes its Object from m_updates, so always take the last.
+    df::PoolAllocator::beginBatch();
+    while (m_updates.getCount() > 0) {
+        const int before = m_updates.getCount();
+        delete m_updates[before - 1];
+        // Guard against an Object whose destructor did not leave the world.
+        if (m_updates.getCount() == before) m_updates.remove(m_updates.getHandle(before - 1));
     }
+    for (ObjectList& parked : m_inactive) {
+        while (parked.getCount() > 0) {
+            const int before = parked.getCount();
+            delete parked[before - 1];
+            if (parked.getCount() == before) parked.remove(parked.getHandle(before - 1));
+        }
+    }
+    df::PoolAllocator::endBatch();
     m_updates.clear();
     m_deletions.clear();
+    m_doomed.clear();
+    m_deactivations.clear();
+    m_grid.clear();
+    m_tree.clear();
+    m_contacts.clear();
+    m_by_type.clear();
+    m_by_altitude.clear();
+    m_inactive.clear();
     df::Manager::shutDown();
 }
 // Insert Object into world. Return 0 if ok, else -1.
 int WorldManager::insertObject(Object* p_o) {
-    return m_updates.insert(p_o);
+    if (p_o == nullptr || m_updates.get(p_o->m_handle) == p_o) return -1;
+    p_o->m_handle = m_updates.insertHandle(p_o);
+    if (!p_o->m_handle.isValid()) return -1;
+    addToTypeBucket(p_o, p_o->m_type_id);
+    if (m_loading) { // loadSnapshot() indexes it at its final state
+        m_loaded.push_back(p_o->m_handle);
+        return 0;
+    }
+    addToCollisionIndex(p_o);
+    addToDrawBucket(p_o, p_o->getAltitude());
+    return 0;
 }
 void WorldManager::setBoundary(int width, int height) {
     // keep sane values
@@ -52,47 +104,251 @@ void WorldManager::setBoundary(int width, int height) {
     m_width = width;
     m_height = height;
 
-    df::LogManager::getInstance().writeLog(
+    df::LogManager::getInstance().writeLog(df::LOG_INFO, df::LOG_WORLD,
         "WorldManager: boundary set to %dx%d\n", m_width, m_height);
 }
 
 // Remove Object from world. Return 0 if ok, else -1.
 int WorldManager::removeObject(Object* p_o) {
+    if (p_o == nullptr) return -1;
     // If scheduled for deletion, drop it from deletions too.
-    for (int i = 0; i < m_deletions.getCount(); ++i) {
-        if (m_deletions[i] == p_o) {
-            m_deletions.remove(p_o);
-            break;
-        }
+    if (p_o->m_marked) {
+        m_deletions.remove(p_o);
+        p_o->m_marked = false;
     }
-    return m_updates.remove(p_o);
+    if (p_o->m_deactivating) {
+        m_deactivations.remove(p_o);
+        p_o->m_deactivating = false;
+    }
+
+    // Parked Objects are only in their recycle list.
+    if (!p_o->m_active) {
+        m_inactive[static_cast<std::size_t>(p_o->m_type_id)].remove(p_o->m_type_handle);
+        p_o->m_type_handle = ObjectHandle();
+        p_o->m_active = true;
+        return 0;
+    }
+
+    // O(1) removal through the Object's handle.
+    if (m_updates.get(p_o->m_handle) != p_o) return -1;
+    if (isIndexed(p_o)) {
+        removeFromCollisionIndex(p_o);
+        removeFromDrawBucket(p_o, p_o->getAltitude());
+    }
+    m_updates.remove(p_o->m_handle);
+    p_o->m_handle = ObjectHandle();
+    m_by_type[static_cast<std::size_t>(p_o->m_type_id)].remove(p_o->m_type_handle);
+    p_o->m_type_handle = ObjectHandle();
+    return 0;
 }
 
-// Return list of all Objects in world.
-ObjectList WorldManager::getAllObjects() const {
-    return m_updates; 
+// Return Object referred to by handle (nullptr if it has left the world).
+Object* WorldManager::getObject(ObjectHandle handle) const {
+    return m_updates.get(handle);
 }
 
-// Return list of all Objects in world matching type.
-ObjectList WorldManager::objectsOfType(std::string type) {
-    ObjectList list;
-    for (int i = 0; i < m_updates.getCount(); ++i) {
-        Object* o = m_updates[i];
-        if (o && o->getType() == type) {
-            list.insert(o);
-        }
+// True if box lies within the cell its Object is anchored in.
+static bool isSingleCell(const Box& box) {
+    return box.getCorner().getX() >= 0.0f && box.getCorner().getY() >= 0.0f
+        && box.getCorner().getX() + box.getHorizontal() <= 1.0f
+        && box.getCorner().getY() + box.getVertical() <= 1.0f;
+}
+
+// Single-cell Objects (the common case) go in the grid, where a lookup
+// is one hash probe; larger boxes go in the tree.
+void WorldManager::addToCollisionIndex(Object* p_o) {
+    if (isSingleCell(p_o->m_box)) m_grid.insert(p_o, p_o->getPosition());
+    else p_o->m_proxy = m_tree.insert(p_o, p_o->getWorldBox());
+}
+
+void WorldManager::removeFromCollisionIndex(Object* p_o) {
+    if (p_o->m_proxy == AABBTree::NULL_NODE) {
+        m_grid.remove(p_o, p_o->getPosition());
+        return;
+    }
+    m_tree.remove(p_o->m_proxy);
+    p_o->m_proxy = AABBTree::NULL_NODE;
+}
+
+// Keep collision index current when an Object changes position.
+void WorldManager::updatePosition(Object* p_o, const Vector& from, const Vector& to) {
+    if (df::JobManager::inParallelJob()) {
+        df::JobManager::defer([this, p_o, from, to] { updatePosition(p_o, from, to); });
+        return;
     }
-    return list;
+    if (!isIndexed(p_o)) return; // not in world (or parked, or mid-load)
+    if (p_o->m_proxy == AABBTree::NULL_NODE) m_grid.move(p_o, from, to);
+    else m_tree.move(p_o->m_proxy, p_o->getWorldBox(to),
+        Vector(to.getX() - from.getX(), to.getY() - from.getY()));
+}
+
+// Keep collision index current when an Object changes its box.
+void WorldManager::updateBox(Object* p_o) {
+    if (df::JobManager::inParallelJob()) {
+        df::JobManager::defer([this, p_o] { updateBox(p_o); });
+        return;
+    }
+    if (!isIndexed(p_o)) return;
+    const bool in_tree = p_o->m_proxy != AABBTree::NULL_NODE;
+    if (in_tree && !isSingleCell(p_o->m_box)) {
+        m_tree.move(p_o->m_proxy, p_o->getWorldBox(), Vector());
+        return;
+    }
+    if (!in_tree && isSingleCell(p_o->m_box)) return;
+    removeFromCollisionIndex(p_o);
+    addToCollisionIndex(p_o);
+}
+
+// Keep type buckets current when an Object changes type.
+void WorldManager::updateType(Object* p_o, int from_id, int to_id) {
+    if (df::JobManager::inParallelJob()) {
+        df::JobManager::defer([this, p_o, from_id, to_id] { updateType(p_o, from_id, to_id); });
+        return;
+    }
+    if (from_id == to_id) return;
+    if (!p_o->m_active) {
+        // Parked: move it to the recycle list of its new type.
+        m_inactive[static_cast<std::size_t>(from_id)].remove(p_o->m_type_handle);
+        const std::size_t type = static_cast<std::size_t>(to_id);
+        if (type >= m_inactive.size()) m_inactive.resize(type + 1);
+        p_o->m_type_handle = m_inactive[type].insertHandle(p_o);
+        return;
+    }
+    if (m_updates.get(p_o->m_handle) != p_o) return;
+    m_by_type[static_cast<std::size_t>(from_id)].remove(p_o->m_type_handle);
+    addToTypeBucket(p_o, to_id);
+}
+
+// Keep draw buckets current when an Object changes altitude.
+void WorldManager::updateAltitude(Object* p_o, int from, int to) {
+    if (df::JobManager::inParallelJob()) {
+        df::JobManager::defer([this, p_o, from, to] { updateAltitude(p_o, from, to); });
+        return;
+    }
+    if (from == to || !isIndexed(p_o)) return;
+    removeFromDrawBucket(p_o, from);
+    addToDrawBucket(p_o, to);
+}
+
+// Append Object to the draw bucket for altitude.
+void WorldManager::addToDrawBucket(Object* p_o, int altitude) {
+    DrawBucket& bucket = m_by_altitude[altitude];
+    const int count = bucket.objects.getCount();
+    if (count > 0 && bucket.objects.getUnchecked(count - 1)->getId() > p_o->getId()) bucket.sorted = false;
+    p_o->m_altitude_handle = bucket.objects.insertHandle(p_o);
+}
+
+// Take Object out of the draw bucket for altitude.
+void WorldManager::removeFromDrawBucket(Object* p_o, int altitude) {
+    DrawBucket& bucket = m_by_altitude[altitude];
+    if (bucket.objects.getHandle(bucket.objects.getCount() - 1) != p_o->m_altitude_handle)
+        bucket.sorted = false; // the last Object moves into the hole
+    bucket.objects.remove(p_o->m_altitude_handle);
+    p_o->m_altitude_handle = ObjectHandle();
+}
+
+// Insert Object into the bucket for type id (growing buckets as needed).
+void WorldManager::addToTypeBucket(Object* p_o, int type_id) {
+    const std::size_t type = static_cast<std::size_t>(type_id);
+    if (type >= m_by_type.size()) m_by_type.resize(type + 1);
+    p_o->m_type_handle = m_by_type[type].insertHandle(p_o);
+}
+
+// Return view of all Objects in world (no copy).
+ObjectListView WorldManager::getAllObjects() const {
+    return ObjectListView(m_updates);
+}
+
+// Return view of all Objects in world matching type (no copy).
+ObjectListView WorldManager::objectsOfType(const std::string& type) const {
+    return objectsOfType(TypeRegistry::getInstance().find(type));
+}
+
+ObjectListView WorldManager::objectsOfType(int type_id) const {
+    if (type_id < 0 || static_cast<std::size_t>(type_id) >= m_by_type.size())
+        return ObjectListView(m_no_objects);
+    return ObjectListView(m_by_type[static_cast<std::size_t>(type_id)]);
 }
 
 // Indicate Object is to be deleted at end of current game loop. Return 0 if ok, else -1.
 int WorldManager::markForDelete(Object* p_o) {
     if (p_o == nullptr) return -1;
+    if (df::JobManager::inParallelJob()) {
+        df::JobManager::defer([this, p_o] { markForDelete(p_o); });
+        return 0;
+    }
     // Prevent duplicates in deletions list.
-    for (int i = 0; i < m_deletions.getCount(); ++i) {
-        if (m_deletions[i] == p_o) return 0;
+    if (p_o->m_marked) return 0;
+    if (m_deletions.insert(p_o) != 0) return -1;
+    p_o->m_marked = true;
+    return 0;
+}
+
+// Indicate Object is to be parked for reuse at end of current update(). Return 0 if ok, else -1.
+int WorldManager::markForDeactivate(Object* p_o) {
+    if (p_o == nullptr) return -1;
+    if (df::JobManager::inParallelJob()) {
+        df::JobManager::defer([this, p_o] { markForDeactivate(p_o); });
+        return 0;
+    }
+    if (p_o->m_deactivating || !p_o->m_active) return 0;
+    if (m_updates.get(p_o->m_handle) != p_o) return -1; // not in world
+    if (m_deactivations.insert(p_o) != 0) return -1;
+    p_o->m_deactivating = true;
+    return 0;
+}
+
+// Take Object out of every world structure and park it by type. Its
+// interests are unregistered but remembered for reactivate().
+void WorldManager::deactivateNow(Object* p_o) {
+    p_o->m_deactivating = false;
+    if (p_o->m_marked || m_updates.get(p_o->m_handle) != p_o) return; // deletion wins
+
+    for (Object::Interest& i : p_o->m_interests) {
+        i.p_manager->unregisterInterest(i.handle, i.event_type);
+        i.handle = ObjectHandle();
     }
-    return m_deletions.insert(p_o);
+    m_updates.remove(p_o->m_handle);
+    p_o->m_handle = ObjectHandle();
+    removeFromCollisionIndex(p_o);
+    m_by_type[static_cast<std::size_t>(p_o->m_type_id)].remove(p_o->m_type_handle);
+    removeFromDrawBucket(p_o, p_o->getAltitude());
+
+    const std::size_t type = static_cast<std::size_t>(p_o->m_type_id);
+    if (type >= m_inactive.size()) m_inactive.resize(type + 1);
+    p_o->m_type_handle = m_inactive[type].insertHandle(p_o);
+    p_o->m_active = false;
+    p_o->setVelocity(0, 0);
+}
+
+// Put a parked Object of type back into the world. Return it, or nullptr if none.
+Object* WorldManager::reactivate(int type_id) {
+    if (type_id < 0 || static_cast<std::size_t>(type_id) >= m_inactive.size()) return nullptr;
+    ObjectList& parked = m_inactive[static_cast<std::size_t>(type_id)];
+    if (parked.getCount() == 0) return nullptr;
+
+    Object* p_o = parked.getUnchecked(parked.getCount() - 1);
+    parked.remove(p_o->m_type_handle);
+    p_o->m_type_handle = ObjectHandle();
+    p_o->m_active = true;
+    p_o->m_id = Object::s_next_id++;
+    insertObject(p_o);
+    for (Object::Interest& i : p_o->m_interests)
+        i.handle = i.p_manager->registerInterest(p_o, i.event_type);
+    return p_o;
+}
+
+// Count of parked Objects of type.
+int WorldManager::getInactiveCount(int type_id) const {
+    if (type_id < 0 || static_cast<std::size_t>(type_id) >= m_inactive.size()) return 0;
+    return m_inactive[static_cast<std::size_t>(type_id)].getCount();
+}
+
+// WorldManager handles all events except step, keyboard and mouse.
+bool WorldManager::isValid(int event_type) const {
+    return event_type != EventStep::TYPE_ID &&
+        event_type != EventKeyboard::TYPE_ID &&
+        event_type != EventMouse::TYPE_ID;
 }
 
 bool WorldManager::withinBounds(const Vector& pos) const {
@@ -101,17 +357,27 @@ bool WorldManager::withinBounds(const Vector& pos) const {
     return (x >= 0 && x < m_width && y >= 0 && y < m_height);
 }
 
-ObjectList WorldManager::getCollisions(Object* mover, const Vector& where) const {
-    ObjectList hits;
-    for (int i = 0; i < m_updates.getCount(); ++i) {
-        const Object* other = m_updates[i]; // only one declaration
-        if (!other || other == mover) continue;
-
-        if (static_cast<int>(other->getPosition().getX()) == static_cast<int>(where.getX()) &&
-            static_cast<int>(other->getPosition().getY()) == static_cast<int>(where.getY())) {
-            hits.insert(const_cast<Object*>(other));
+// Return Objects whose boxes overlap mover's box at where: single-cell
+// Objects from the grid cells the box covers, larger ones from the tree
+// (candidates by fat box). Each is confirmed against its real box.
+SmallObjectList<> WorldManager::getCollisions(Object* mover, const Vector& where) const {
+    SmallObjectList<> hits;
+    const Box box = mover->getWorldBox(where);
+    const int x0 = static_cast<int>(std::floor(box.getCorner().getX()));
+    const int y0 = static_cast<int>(std::floor(box.getCorner().getY()));
+    const int x1 = static_cast<int>(std::ceil(box.getCorner().getX() + box.getHorizontal()));
+    const int y1 = static_cast<int>(std::ceil(box.getCorner().getY() + box.getVertical()));
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            const std::vector<Object*>* cell = m_grid.query(Vector(static_cast<float>(x), static_cast<float>(y)));
+            if (!cell) continue;
+            for (Object* other : *cell)
+                if (other != mover && box.intersects(other->getWorldBox())) hits.insert(other);
         }
     }
+    m_tree.query(box, [&](Object* other) {
+        if (other != mover && box.intersects(other->getWorldBox())) hits.insert(other);
+    });
     return hits;
 }
 
@@ -127,31 +393,17 @@ bool WorldManager::moveObject(Object* p_o, const Vector& to) {
     }
 
     // 2) Collisions at destination
-    ObjectList hits = getCollisions(p_o, to);
+    // (Snapshot, since handlers may move Objects between grid cells.)
+    const SmallObjectList<> hits = getCollisions(p_o, to);
 
-    // If any hit is solid vs solid, block and emit collisions to both
+    // Any solid vs solid hit blocks; spectral ones pass through. Every hit
+    // refreshes the pair's contact (events only on first touch).
     bool blocked = false;
-    for (int i = 0; i < hits.getCount(); ++i) {
-        Object* other = hits[i];
-        if (!other) continue;
-
+    for (Object* other : hits) {
         const bool mover_solid = p_o->getSolidness() != Solidness::SPECTRAL;
         const bool other_solid = other->getSolidness() != Solidness::SPECTRAL;
-
-        if (mover_solid && other_solid) {
-            EventCollision col(p_o, other, to);
-            p_o->onEvent(col);
-            other->onEvent(col);
-            blocked = true;
-            // note: keep checking others to send all collision events this step
-        }
-        else {
-            // At least one spectral -> allow pass-through but still send event
-            EventCollision col(p_o, other, to);
-            p_o->onEvent(col);
-            other->onEvent(col);
-            // do not mark blocked
-        }
+        if (mover_solid && other_solid) blocked = true;
+        touchContact(p_o, other, to);
     }
 
     if (blocked) return false;
@@ -160,50 +412,395 @@ bool WorldManager::moveObject(Object* p_o, const Vector& to) {
     return true;
 }
 
+// Record that mover touched other at where this step. A new contact
+// sends BEGIN to both; a known one sends STAY if enabled.
+void WorldManager::touchContact(Object* p_o, Object* p_other, const Vector& where) {
+    const std::uint32_t id_a = static_cast<std::uint32_t>(p_o->getId());
+    const std::uint32_t id_b = static_cast<std::uint32_t>(p_other->getId());
+    const std::uint64_t key = id_a < id_b
+        ? (static_cast<std::uint64_t>(id_a) << 32) | id_b
+        : (static_cast<std::uint64_t>(id_b) << 32) | id_a;
+
+    auto found = m_contacts.find(key);
+    CollisionPhase phase = CollisionPhase::BEGIN;
+    if (found == m_contacts.end()) {
+        m_contacts.emplace(key, Contact{ p_o->m_handle, p_other->m_handle, where, m_frame });
+    }
+    else {
+        // Ids are never reused, so the key always names this same pair.
+        found->second.where = where;
+        found->second.frame = m_frame;
+        if (!m_contact_stay) return;
+        phase = CollisionPhase::STAY;
+    }
+    EventCollision col(p_o, p_other, where, phase);
+    p_o->onEvent(col);
+    p_other->onEvent(col);
+}
+
+// End contacts no move refreshed this update whose boxes no longer
+// overlap, and forget those with an Object that has left the world.
+void WorldManager::endContacts() {
+    m_ended.clear();
+    for (auto it = m_contacts.begin(); it != m_contacts.end();) {
+        const Contact& c = it->second;
+        const Object* a = getObject(c.a);
+        const Object* b = getObject(c.b);
+        if (a && b && (c.frame == m_frame || a->getWorldBox().intersects(b->getWorldBox()))) {
+            ++it;
+            continue;
+        }
+        if (a && b) m_ended.push_back(c);
+        it = m_contacts.erase(it);
+    }
+
+    // Send after the walk: handlers may remove Objects.
+    for (const Contact& c : m_ended) {
+        Object* a = getObject(c.a);
+        Object* b = getObject(c.b);
+        if (!a || !b) continue;
+        EventCollision col(a, b, c.where, CollisionPhase::END);
+        a->onEvent(col);
+        b->onEvent(col);
+    }
+}
+
 // Update world. Move objects according to their velocity.
 void WorldManager::update() {
-    for (int i = 0; i < m_updates.getCount(); ++i) {
-        Object* o = m_updates[i];
-        if (!o) continue;
+    // Integrate destinations of the moving set, then resolve bounds and
+    // collisions mover by mover. Objects at rest cost nothing here. Movers
+    // are taken by handle first, since handlers may stop, spawn or delete
+    // Objects; ones spawned or started during this phase move next frame.
+    df::ProfileScope update_scope(df::PHASE_UPDATE);
+    df::TraceScope trace("WorldManager::update");
+    TransformStore& ts = TransformStore::getInstance();
+    {
+        df::ProfileScope scope(df::PHASE_MOVE);
+        ts.integrate();
+    }
+    {
+        df::ProfileScope scope(df::PHASE_COLLIDE);
+        m_movers.clear();
+        const int count = ts.getMovingCount();
+        for (int j = 0; j < count; ++j) {
+            const Object* o = ts.getOwner(ts.getMoving(j));
+            if (o->m_handle.isValid()) m_movers.push_back(o->m_handle); // in world
+        }
+        for (const ObjectHandle& h : m_movers) {
+            Object* o = m_updates.get(h);
+            if (!o || !ts.isMoving(o->m_transform)) continue;
+            (void)moveObject(o, ts.getDestination(o->m_transform));
+        }
+        endContacts();
+        ++m_frame;
+    }
 
-        const float vx = o->getVelocityX();
-        const float vy = o->getVelocityY();
-        if (vx == 0.0f && vy == 0.0f) continue;
+    // Take the pending list first: each destructor calls removeObject(),
+    // which must not reshuffle the list being walked. Swapping with
+    // m_doomed keeps both lists' storage, and pooled Objects return their
+    // blocks in one batch, so steady-state despawning does not allocate.
+    df::ProfileScope scope(df::PHASE_DELETE);
+    for (int i = 0; i < m_deactivations.getCount(); ++i)
+        deactivateNow(m_deactivations.getUnchecked(i));
+    m_deactivations.clear();
+    std::swap(m_doomed, m_deletions);
+    df::PoolAllocator::beginBatch();
+    for (int i = 0; i < m_doomed.getCount(); ++i) {
+        if (Object* o = m_doomed[i]) delete o;
+    }
+    df::PoolAllocator::endBatch();
+    m_doomed.clear();
+}
 
-        Vector from = o->getPosition();
-        Vector to(from.getX() + vx, from.getY() + vy);
 
-        (void)moveObject(o, to);
+// Center view on world position, kept inside the world boundary.
+void WorldManager::setViewPosition(const Vector& center) {
+    const float w = m_view.getHorizontal(), h = m_view.getVertical();
+    float x = center.getX() - w / 2, y = center.getY() - h / 2;
+    x = std::max(0.0f, std::min(x, static_cast<float>(m_width) - w));
+    y = std::max(0.0f, std::min(y, static_cast<float>(m_height) - h));
+    m_view.setCorner(Vector(std::floor(x), std::floor(y)));
+}
+
+// Draw Objects overlapping the view to screen, lowest altitude first.
+void WorldManager::draw() {
+    df::TraceScope trace("WorldManager::draw");
+    const Box view = m_view;
+    const int x0 = static_cast<int>(std::floor(view.getCorner().getX()));
+    const int y0 = static_cast<int>(std::floor(view.getCorner().getY()));
+    const int x1 = static_cast<int>(std::ceil(view.getCorner().getX() + view.getHorizontal()));
+    const int y1 = static_cast<int>(std::ceil(view.getCorner().getY() + view.getVertical()));
+    const long long view_cells = static_cast<long long>(x1 - x0) * (y1 - y0);
+
+    if (view_cells >= m_updates.getCount()) {
+        // Few Objects for the view's size: walk the buckets, restoring id
+        // order where removals disturbed it. Indexed loops: a draw() that
+        // spawns Objects may grow a bucket.
+        for (auto& bucket : m_by_altitude) {
+            ObjectList& list = bucket.second.objects;
+            if (!bucket.second.sorted) {
+                list.sort([](const Object* a, const Object* b) { return a->getId() < b->getId(); });
+                bucket.second.sorted = true;
+            }
+            for (int i = 0; i < list.getCount(); ++i) {
+                Object* o = list.getUnchecked(i);
+                if (view.intersects(o->getWorldBox())) (void)o->draw();
+            }
+        }
+        return;
     }
 
-    for (int i = 0; i < m_deletions.getCount(); ++i) {
-        if (Object* o = m_deletions[i]) {
-            m_updates.remove(o);
-            delete o;
+    // Large world: only look at what is under the view. Each visible
+    // Object goes to its altitude bucket's scratch list, so the buckets
+    // hand them back in altitude order without a sort across altitudes.
+    // Within one, the list is put in id order to match the bucket walk.
+    for (auto& bucket : m_by_altitude) bucket.second.visible.clear();
+    int altitude = 0;
+    DrawBucket* p_bucket = nullptr; // Bucket of the previous visible Object.
+    auto collect = [&](Object* o) {
+        if (!p_bucket || o->getAltitude() != altitude) {
+            altitude = o->getAltitude();
+            p_bucket = &m_by_altitude[altitude];
+        }
+        p_bucket->visible.push_back(o);
+    };
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            const std::vector<Object*>* cell = m_grid.query(Vector(static_cast<float>(x), static_cast<float>(y)));
+            if (!cell) continue;
+            for (Object* o : *cell)
+                if (view.intersects(o->getWorldBox())) collect(o);
         }
     }
-    m_deletions.clear();
+    m_tree.query(view, [&](Object* o) {
+        if (view.intersects(o->getWorldBox())) collect(o);
+    });
+    const auto by_id = [](const Object* a, const Object* b) { return a->getId() < b->getId(); };
+    for (auto& bucket : m_by_altitude) {
+        std::vector<Object*>& visible = bucket.second.visible;
+        if (!std::is_sorted(visible.begin(), visible.end(), by_id)) std::sort(visible.begin(), visible.end(), by_id);
+        for (std::size_t i = 0; i < visible.size(); ++i) (void)visible[i]->draw();
+    }
 }
 
 
-// Draw all objects to screen.
-void WorldManager::draw() {
-    std::vector<Object*> order;
-    order.reserve(static_cast<size_t>(m_updates.getCount()));
-    for (int i = 0; i < m_updates.getCount(); ++i) {
-        if (auto* o = m_updates[i]) order.push_back(o);
+// Snapshot file: header, type-name table, then one record per Object.
+// Fields are host-endian and unaligned (read with memcpy).
+//   header: "DFSN", u32 version, u32 type count, u32 Object count
+//   type:   u32 name length, name bytes
+//   Object: u32 type index, f32 x, y, vx, vy, i32 solidness, i32 altitude,
+//           u32 payload size, payload bytes
+namespace {
+    const char SNAPSHOT_MAGIC[4] = { 'D', 'F', 'S', 'N' };
+    const std::uint32_t SNAPSHOT_VERSION = 1;
+    const std::size_t SNAPSHOT_RECORD_SIZE = 32; // Fixed part of an Object record.
+
+    template <class T> void put(std::vector<char>& out, const T& v) {
+        const char* p = reinterpret_cast<const char*>(&v);
+        out.insert(out.end(), p, p + sizeof(T));
     }
 
-    std::sort(order.begin(), order.end(),
-        [](const Object* a, const Object* b) {
-            if (a->getAltitude() != b->getAltitude())
-                return a->getAltitude() < b->getAltitude();  
-            return a->getId() < b->getId();                  
-        });
+    // Bounds-checked cursor over the mapped file.
+    struct SnapshotReader {
+        const char* p;
+        const char* end;
+
+        std::size_t remaining() const { return static_cast<std::size_t>(end - p); }
+        template <class T> bool get(T& v) {
+            if (remaining() < sizeof(T)) return false;
+            std::memcpy(&v, p, sizeof(T));
+            p += sizeof(T);
+            return true;
+        }
+        bool skip(std::size_t n) {
+            if (remaining() < n) return false;
+            p += n;
+            return true;
+        }
+    };
+
+    struct SnapshotRecord {
+        std::uint32_t type;
+        float x, y, vx, vy;
+        std::int32_t solidness, altitude;
+        std::uint32_t payload_size;
+        const char* payload;
+    };
+
+    bool readRecord(SnapshotReader& in, SnapshotRecord& r) {
+        if (!in.get(r.type) || !in.get(r.x) || !in.get(r.y) || !in.get(r.vx) || !in.get(r.vy)
+            || !in.get(r.solidness) || !in.get(r.altitude) || !in.get(r.payload_size)) return false;
+        r.payload = in.p;
+        return in.skip(r.payload_size);
+    }
+}
+
+// Let snapshots create Objects of type.
+void WorldManager::registerSnapshotType(const std::string& type, Object* (*create)()) {
+    const std::size_t id = static_cast<std::size_t>(TypeRegistry::getInstance().intern(type));
+    if (id >= m_factories.size()) m_factories.resize(id + 1, nullptr);
+    m_factories[id] = create;
+}
+
+// Write every Object in the world to a binary snapshot. Return count, or -1.
+int WorldManager::saveSnapshot(const std::string& path) const {
+    df::TraceScope trace("WorldManager::saveSnapshot");
+    const TypeRegistry& types = TypeRegistry::getInstance();
+    const int count = m_updates.getCount();
+
+    // Number the types in use in order of first appearance.
+    std::vector<int> index_of(static_cast<std::size_t>(types.getCount()), -1);
+    std::vector<int> used;
+    std::vector<char> records, payload;
+    records.reserve(static_cast<std::size_t>(count) * SNAPSHOT_RECORD_SIZE);
+    for (int i = 0; i < count; ++i) {
+        const Object* o = m_updates.getUnchecked(i);
+        int& index = index_of[static_cast<std::size_t>(o->m_type_id)];
+        if (index < 0) {
+            index = static_cast<int>(used.size());
+            used.push_back(o->m_type_id);
+        }
+        payload.clear();
+        o->savePayload(payload);
+        put(records, static_cast<std::uint32_t>(index));
+        put(records, o->getPosition().getX());
+        put(records, o->getPosition().getY());
+        put(records, o->getVelocityX());
+        put(records, o->getVelocityY());
+        put(records, static_cast<std::int32_t>(o->getSolidness()));
+        put(records, static_cast<std::int32_t>(o->getAltitude()));
+        put(records, static_cast<std::uint32_t>(payload.size()));
+        records.insert(records.end(), payload.begin(), payload.end());
+    }
 
-    for (auto* o : order) {
-        if (o) (void)o->draw();
+    std::vector<char> head;
+    head.insert(head.end(), SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 4);
+    put(head, SNAPSHOT_VERSION);
+    put(head, static_cast<std::uint32_t>(used.size()));
+    put(head, static_cast<std::uint32_t>(count));
+    for (int id : used) {
+        const std::string& name = types.getName(id);
+        put(head, static_cast<std::uint32_t>(name.size()));
+        head.insert(head.end(), name.begin(), name.end());
+    }
+
+    FILE* p_f = nullptr;
+    if (fopen_s(&p_f, path.c_str(), "wb") != 0 || !p_f) {
+        df::LogManager::getInstance().writeLog(df::LOG_ERROR, df::LOG_WORLD,
+            "WorldManager: cannot write snapshot %s\n", path.c_str());
+        return -1;
+    }
+    const bool ok = fwrite(head.data(), 1, head.size(), p_f) == head.size()
+        && fwrite(records.data(), 1, records.size(), p_f) == records.size();
+    if (fclose(p_f) != 0 || !ok) {
+        df::LogManager::getInstance().writeLog(df::LOG_ERROR, df::LOG_WORLD,
+            "WorldManager: error writing snapshot %s\n", path.c_str());
+        return -1;
+    }
+    return count;
+}
+
+// Add the Objects of a snapshot to the world. Return count, or -1.
+int WorldManager::loadSnapshot(const std::string& path) {
+    df::TraceScope trace("WorldManager::loadSnapshot");
+    df::LogManager& log = df::LogManager::getInstance();
+    MappedFile file;
+    if (file.open(path) != 0) {
+        log.writeLog(df::LOG_ERROR, df::LOG_WORLD, "WorldManager: cannot read snapshot %s\n", path.c_str());
+        return -1;
+    }
+
+    SnapshotReader in{ file.getData(), file.getData() + file.getSize() };
+    char magic[4];
+    std::uint32_t version = 0, type_count = 0, count = 0;
+    if (!in.get(magic) || std::memcmp(magic, SNAPSHOT_MAGIC, 4) != 0 || !in.get(version)
+        || version != SNAPSHOT_VERSION || !in.get(type_count) || !in.get(count)) {
+        log.writeLog(df::LOG_ERROR, df::LOG_WORLD, "WorldManager: %s is not a snapshot\n", path.c_str());
+        return -1;
+    }
+
+    // Each type name takes at least its length and each record its fixed
+    // part, so a header claiming more than the file holds is rejected
+    // before anything is sized by it.
+    if (in.remaining() / sizeof(std::uint32_t) < type_count
+        || (in.remaining() - type_count * sizeof(std::uint32_t)) / SNAPSHOT_RECORD_SIZE < count) {
+        log.writeLog(df::LOG_ERROR, df::LOG_WORLD, "WorldManager: snapshot %s is truncated (%u types, %u records expected)\n",
+            path.c_str(), static_cast<unsigned>(type_count), static_cast<unsigned>(count));
+        return -1;
+    }
+
+    // Resolve every type to a factory before creating anything.
+    std::vector<Object* (*)()> create;
+    create.reserve(type_count);
+    for (std::uint32_t t = 0; t < type_count; ++t) {
+        std::uint32_t length = 0;
+        if (!in.get(length) || in.remaining() < length) {
+            log.writeLog(df::LOG_ERROR, df::LOG_WORLD, "WorldManager: snapshot %s has a truncated type name\n", path.c_str());
+            return -1;
+        }
+        const std::string name(in.p, length);
+        in.skip(length);
+        const int id = TypeRegistry::getInstance().find(name);
+        Object* (*p_create)() = id >= 0 && static_cast<std::size_t>(id) < m_factories.size()
+            ? m_factories[static_cast<std::size_t>(id)] : nullptr;
+        if (!p_create) {
+            log.writeLog(df::LOG_ERROR, df::LOG_WORLD, "WorldManager: no snapshot factory for type %s\n", name.c_str());
+            return -1;
+        }
+        create.push_back(p_create);
+    }
+
+    // Validate every record, so a truncated file creates nothing.
+    const SnapshotReader records = in;
+    if (in.remaining() / SNAPSHOT_RECORD_SIZE < count) {
+        log.writeLog(df::LOG_ERROR, df::LOG_WORLD, "WorldManager: snapshot %s is truncated (%u records expected)\n",
+            path.c_str(), static_cast<unsigned>(count));
+        return -1;
+    }
+    SnapshotRecord r;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        if (!readRecord(in, r) || r.type >= type_count
+            || r.solidness < 0 || r.solidness > static_cast<std::int32_t>(Solidness::SPECTRAL)) {
+            log.writeLog(df::LOG_ERROR, df::LOG_WORLD, "WorldManager: snapshot %s is corrupt\n", path.c_str());
+            return -1;
+        }
+    }
+
+    // Create one by one through the factories, into storage reserved up
+    // front. Constructors insert into the world list and type buckets
+    // only; setters write straight into the TransformStore.
+    m_updates.reserve(m_updates.getCount() + static_cast<int>(count));
+    TransformStore& ts = TransformStore::getInstance();
+    ts.reserve(ts.getCount() + static_cast<int>(count));
+    m_loaded.clear();
+    m_loaded.reserve(count);
+    in = records;
+    m_loading = true;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        readRecord(in, r);
+        Object* o = create[r.type]();
+        o->setPosition(Vector(r.x, r.y));
+        o->setVelocity(r.vx, r.vy);
+        o->setSolidness(static_cast<Solidness>(r.solidness));
+        o->setAltitude(r.altitude);
+        if (o->loadPayload(r.payload, r.payload_size) != 0)
+            log.writeLog(df::LOG_WARNING, df::LOG_WORLD, "WorldManager: %s payload not restored (id %d)\n",
+                o->getType().c_str(), o->getId());
+    }
+    m_loading = false;
+
+    // Index everything inserted meanwhile (children the constructors
+    // spawned too) once, at its final position, box and altitude.
+    m_grid.reserve(static_cast<std::size_t>(m_updates.getCount()));
+    for (ObjectHandle h : m_loaded) {
+        Object* o = m_updates.get(h);
+        if (!o || isIndexed(o)) continue; // deleted (or already indexed) during the load
+        addToCollisionIndex(o);
+        addToDrawBucket(o, o->getAltitude());
     }
+    m_loaded.clear();
+    log.writeLog(df::LOG_INFO, df::LOG_WORLD, "WorldManager: loaded %u Objects from %s\n", static_cast<unsigned>(count), path.c_str());
+    return static_cast<int>(count);
 }
 
 
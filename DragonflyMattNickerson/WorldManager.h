@@ -1,7 +1,16 @@
 #pragma once
 #include "Manager.h"
 #include "ObjectList.h"
+#include "ObjectListView.h"
+#include "SmallObjectList.h"
+#include "AABBTree.h"
+#include "SpatialGrid.h"
+#include <cstdint>
+#include <deque>
+#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 
 class WorldManager : public df::Manager {
@@ -12,14 +21,60 @@ private:
 
 	ObjectList m_updates; // All Objects in world to update.
 	ObjectList m_deletions; // All Objects in world to delete.
+	ObjectList m_doomed; // Deletions being processed; kept to reuse its storage.
+	ObjectList m_deactivations; // Objects to park at end of update().
+	std::deque<ObjectList> m_inactive; // Parked Objects by type id, ready to reactivate.
+
+	// Pairs currently touching, keyed by their ids (low id in the high
+	// bits). Handles go stale when either leaves the world, so nothing
+	// has to be purged on removal.
+	struct Contact {
+		ObjectHandle a, b;
+		Vector where; // Last position the pair touched at.
+		unsigned frame; // Last update() a move found the pair touching.
+	};
+	std::unordered_map<std::uint64_t, Contact> m_contacts;
+	std::vector<Contact> m_ended; // Scratch for end events (kept to reuse storage).
+	unsigned m_frame{ 0 }; // Counts update() calls.
+	bool m_contact_stay{ false };
+	SpatialGrid m_grid; // Single-cell Objects bucketed by grid cell for collision queries.
+	AABBTree m_tree; // Objects whose boxes span more than one cell.
+	std::deque<ObjectList> m_by_type; // Objects bucketed by type id (deque: growth keeps views valid).
+	// Objects of one altitude, drawn in id order. Appends keep that order;
+	// a removal (swap-and-pop) or an older Object arriving clears sorted
+	// and the next bucket walk in draw() restores it.
+	struct DrawBucket {
+		ObjectList objects;
+		bool sorted{ true };
+		std::vector<Object*> visible; // Scratch for draw() culling (kept to reuse storage).
+	};
+	std::map<int, DrawBucket> m_by_altitude; // Draw buckets in altitude order.
+	ObjectList m_no_objects; // Always empty (view for unknown types).
 	
 	int m_width{ 80 };
 	int m_height{ 24 };
+	Box m_view{ Vector(0, 0), 80, 24 }; // Part of the world shown on screen.
+	std::vector<ObjectHandle> m_movers; // Scratch for update(): moving Objects this frame.
+	std::vector<Object* (*)()> m_factories; // Snapshot factories by type id (nullptr if none).
+	std::vector<ObjectHandle> m_loaded; // Scratch for loadSnapshot(): handles, as Objects may die mid-load.
+	bool m_loading{ false }; // In loadSnapshot(): inserted Objects are indexed at the end.
 
 	// Helpers
 	bool withinBounds(const Vector& pos) const;
-	ObjectList getCollisions(Object* mover, const Vector& where) const;
+	SmallObjectList<> getCollisions(Object* mover, const Vector& where) const;
 	bool moveObject(Object* p_o, const Vector& to); 
+	void touchContact(Object* p_o, Object* p_other, const Vector& where);
+	void endContacts();
+	void addToTypeBucket(Object* p_o, int type_id);
+	void deactivateNow(Object* p_o);
+	void addToCollisionIndex(Object* p_o); // Grid or tree, depending on box.
+	void removeFromCollisionIndex(Object* p_o);
+	void addToDrawBucket(Object* p_o, int altitude);
+	void removeFromDrawBucket(Object* p_o, int altitude);
+	// In world with collision index and draw bucket (not yet, mid-load).
+	bool isIndexed(const Object* p_o) const {
+		return m_updates.get(p_o->m_handle) == p_o && p_o->m_altitude_handle.isValid();
+	}
 
 public:
 	// Get the one and only instance of the WorldManager.
@@ -42,12 +97,37 @@ public:
 	int removeObject(class Object* p_o);
 
 
-	// Return list of all Objects in world.
-	ObjectList getAllObjects() const;
+	// Keep collision tree current when an Object changes position.
+	void updatePosition(class Object* p_o, const Vector& from, const Vector& to);
 
 
-	// Return list of all Objects in world matching type.
-	ObjectList objectsOfType(std::string type);
+	// Keep collision tree current when an Object changes its box.
+	void updateBox(class Object* p_o);
+
+
+	// Keep type buckets current when an Object changes type.
+	void updateType(class Object* p_o, int from_id, int to_id);
+
+
+	// Keep draw buckets current when an Object changes altitude.
+	void updateAltitude(class Object* p_o, int from, int to);
+
+
+	// Return Object referred to by handle (nullptr if it has left the world).
+	Object* getObject(ObjectHandle handle) const;
+
+
+	// Return view of all Objects in world (no copy).
+	ObjectListView getAllObjects() const;
+
+
+	// Return view of all Objects in world matching type (no copy).
+	ObjectListView objectsOfType(const std::string& type) const;
+	ObjectListView objectsOfType(int type_id) const;
+
+
+	// WorldManager handles all events except step, keyboard and mouse.
+	bool isValid(int event_type) const override;
 
 
 	// Update world. Delete Objects marked for deletion.
@@ -57,6 +137,27 @@ public:
 	// Indicate Object is to be deleted at end of current game loop. Return 0 if ok, else -1.
 	int markForDelete(class Object* p_o);
 
+
+	// Indicate Object is to be parked for reuse at end of current update().
+	// Ignored if it is also marked for deletion. Return 0 if ok, else -1.
+	int markForDeactivate(class Object* p_o);
+
+
+	// Put a parked Object of type back into the world and return it
+	// (nullptr if none is parked). It gets a fresh id, zero velocity and
+	// its old interests back; the caller resets position and game state.
+	// Skips what creating one costs: the constructor, the heap allocation,
+	// the type-name intern and a new TransformStore slot. Re-entering the
+	// world still redoes the list, type-bucket, collision-index and
+	// draw-bucket inserts and re-registers each interest (these reuse
+	// freed capacity, but a grid cell may still grow). Main thread only.
+	Object* reactivate(int type_id);
+	template <class T> T* reactivate(int type_id) { return static_cast<T*>(reactivate(type_id)); }
+
+
+	// Count of parked Objects of type.
+	int getInactiveCount(int type_id) const;
+
 	// Set/get world boundary (default 80x24).
 	void setBoundary(int width, int height);
 
@@ -66,7 +167,71 @@ public:
 	// Get world boundary.
 	int  getBoundaryHeight() const { return m_height; }
 
-	// Draw all objects to screen.
+	// Collisions are tracked per pair: EventCollision is sent to both
+	// Objects with CollisionPhase::BEGIN when they first touch and END once
+	// they neither overlap nor run into each other. With stay on, every
+	// further step they touch also sends STAY (the pre-contact behavior).
+	// Contacts with an Object that leaves the world end without an event.
+	void setContactStay(bool stay = true) { m_contact_stay = stay; }
+	bool getContactStay() const { return m_contact_stay; }
+
+
+	// Count of pairs currently in contact.
+	int getContactCount() const { return static_cast<int>(m_contacts.size()); }
+
+
+	// Set/get view (camera): the rectangle of the world shown on screen,
+	// in world coordinates. Default is 80x24 at the origin.
+	void setView(const Box& view) { m_view = view; }
+	const Box& getView() const { return m_view; }
+
+
+	// Center view on world position, kept inside the world boundary.
+	void setViewPosition(const Vector& center);
+
+
+	// Map world position to screen (view) position and back.
+	Vector worldToView(const Vector& world_pos) const {
+		return Vector(world_pos.getX() - m_view.getCorner().getX(), world_pos.getY() - m_view.getCorner().getY());
+	}
+	Vector viewToWorld(const Vector& view_pos) const {
+		return Vector(view_pos.getX() + m_view.getCorner().getX(), view_pos.getY() + m_view.getCorner().getY());
+	}
+
+
+	// Let snapshots create Objects of type: create returns a new Object
+	// already of that type (its constructor adds it to the world, as usual).
+	void registerSnapshotType(const std::string& type, Object* (*create)());
+	template <class T> void registerSnapshotType(const std::string& type) {
+		registerSnapshotType(type, []() -> Object* { return new T; });
+	}
+
+
+	// Write every Object in the world (parked ones excluded) to a binary
+	// snapshot at path: type, position, velocity, solidness, altitude and
+	// the per-type payload (Object::savePayload()). Return count written,
+	// or -1 on error. Main thread only.
+	int saveSnapshot(const std::string& path) const;
+
+
+	// Add the Objects of a snapshot to the world: one memory-mapped read,
+	// then each Object is built by its registered factory (constructor and
+	// setters run as usual) into storage reserved for the whole file. Only
+	// collision indexing and draw buckets are deferred, and done once at
+	// the end. Objects get fresh ids.
+	// Return count loaded, or -1 (nothing created) if the file is missing
+	// or malformed or a type has no factory. Main thread, outside update().
+	int loadSnapshot(const std::string& path);
+
+
+	// Draw Objects whose boxes overlap the view, lowest altitude first.
+	// Usually the persistent per-altitude buckets are walked with a box
+	// test. When the view covers fewer cells than there are Objects,
+	// visible ones come from the collision grid and tree instead and are
+	// grouped into their altitude buckets (no sort across altitudes).
+	// Both paths draw an altitude in id order, so overlapping Objects
+	// keep their stacking even when spawns or deaths switch the path.
+	// No allocation once warmed up.
 	void draw();
 };
 